@@ -11,7 +11,9 @@
 */
 
 #include "ag.hpp"
+#include "ilhas.hpp"
 #include <iostream>
+#include <limits>
 
 //Apenas letura
 TMapaGenes *TAlgGenetico::getMapa() { return VP_Mapa; }
@@ -34,6 +36,12 @@ void TAlgGenetico::setSelecao (int val)                 { VP_selecao
 void TAlgGenetico::setSelIndMutacao (int val)           { VP_selIndMutacao           = val; }
 void TAlgGenetico::setPercentReducao (int val)          { VP_percentReducao          = val; }
 void TAlgGenetico::setPercentMutacaoRecursiva (int val) { VP_percentMutacaoRecursiva = val; }
+void TAlgGenetico::setNumThreads (int val)              { VP_numThreads = val; VP_tarefasRecursivas = val; }
+void TAlgGenetico::setTarefasRecursivas (int val)       { VP_tarefasRecursivas       = val; }
+void TAlgGenetico::setRegistroBinario (bool val)        { VP_registroBinario         = val; }
+void TAlgGenetico::setNivelLog (int val)                { VP_nivelLog                = val; }
+void TAlgGenetico::setAmostragemLog (int val)           { VP_amostragemLog           = val; }
+void TAlgGenetico::setIntervaloLog (int val)            { VP_intervaloLog            = (val > 0)?val:1; }
 
 int TAlgGenetico::getPercentReducao ()          { return VP_percentReducao; }
 int TAlgGenetico::getPercentMutacaoRecursiva () { return VP_percentMutacaoRecursiva; }
@@ -48,6 +56,12 @@ int TAlgGenetico::getCruzamento ()              { return VP_cruzamento; }
 int TAlgGenetico::getPercentElitismo ()         { return VP_percentElitismo; }
 int TAlgGenetico::getSelecao ()                 { return VP_selecao; }
 int TAlgGenetico::getSelIndMutacao ()           { return VP_selIndMutacao; }
+int TAlgGenetico::getNumThreads ()              { return VP_numThreads; }
+int TAlgGenetico::getTarefasRecursivas ()      { return VP_tarefasRecursivas; }
+bool TAlgGenetico::is_registroBinario ()        { return VP_registroBinario; }
+int TAlgGenetico::getNivelLog ()                { return VP_nivelLog; }
+int TAlgGenetico::getAmostragemLog ()           { return VP_amostragemLog; }
+int TAlgGenetico::getIntervaloLog ()            { return VP_intervaloLog; }
 
 unsigned TAlgGenetico::getEntradaRec() { return VP_Entr_Rec; }
 unsigned TAlgGenetico::getExecRec()    { return VP_Exec_Rec; }
@@ -66,6 +80,19 @@ TAlgGenetico::TAlgGenetico (TMapaGenes *mapa, TArqLog *arqSaida)
 	VP_Entr_Rec 	 = 0;
 	VP_Exec_Rec     = 0;
 	VP_Comb_Rec     = 0;
+   VP_mapaReduzido = NULL;
+   VP_mapaFilhos   = NULL;
+   VP_cache        = NULL;
+   VP_numThreads   = 0;
+   VP_tarefasRecursivas = 0;
+   VP_registroBinario = false;
+   VP_nivelLog     = nivelTodas;
+   VP_amostragemLog = amostragemTodas;
+   VP_intervaloLog = 1;
+   VP_melhorRegistrado = numeric_limits<double>::infinity();
+   VP_ilhas        = NULL;
+   VP_idIlha       = 0;
+   VP_filhosPorSlot = 1;
 }
 
 TAlgGenetico::TAlgGenetico (TMapaGenes *mapa, TArqLog *arqSaida, int profundidade)
@@ -76,11 +103,42 @@ TAlgGenetico::TAlgGenetico (TMapaGenes *mapa, TArqLog *arqSaida, int profundidad
 	VP_Entr_Rec     = 0;
 	VP_Exec_Rec     = 0;
 	VP_Comb_Rec     = 0;
+   VP_mapaReduzido = NULL;
+   VP_mapaFilhos   = NULL;
+   VP_cache        = NULL;
+   VP_numThreads   = 0;
+   VP_tarefasRecursivas = 0;
+   VP_registroBinario = false;
+   VP_nivelLog     = nivelTodas;
+   VP_amostragemLog = amostragemTodas;
+   VP_intervaloLog = 1;
+   VP_melhorRegistrado = numeric_limits<double>::infinity();
+   VP_ilhas        = NULL;
+   VP_idIlha       = 0;
+   VP_filhosPorSlot = 1;
 }
 
 TAlgGenetico::~TAlgGenetico ()
 {
+   delete VP_mapaFilhos;
+   delete VP_cache;
 
+   for (unsigned i=0; i<VP_mapasTarefas.size(); i++)
+      delete VP_mapasTarefas[i];
+}
+
+void TAlgGenetico::setMapaReduzido (TMapaGenes *mapa) { VP_mapaReduzido = mapa; }
+
+void TAlgGenetico::setIlha (TIlhas *ilhas, int id)
+{
+   VP_ilhas  = ilhas;
+   VP_idIlha = id;
+}
+
+void TAlgGenetico::setTamCacheRecursao (int val)
+{
+   delete VP_cache;
+   VP_cache = (val>0)?new TCacheRecursao(val):NULL;
 }
 
 double TAlgGenetico::get_melhor_dst()
@@ -99,6 +157,20 @@ void TAlgGenetico::exec(TIndividuo *indBase, TTabConversao *tabConversao, int ex
    if (get_profundidade() >= getProfundidadeMaxima()) return;
    
    TIndividuo *melhor;
+   TMapaGenes *mapaOriginal = VP_Mapa;
+   vector<TTipoConversao> tc;
+
+   //Com poucos fragmentos, a recursão usa um mapa denso só com eles,
+   //que cabe na cache, e cada fragmento passa a ser um gene desse mapa
+   if ((VP_mapaReduzido != NULL)&&(tabConversao->get_quantidade() <= TTabConversao::limiteMapaReduzido))
+   {
+      tabConversao->preencheMapaReduzido(mapaOriginal, VP_mapaReduzido);
+      VP_Mapa = VP_mapaReduzido;
+      tc = tabConversao->get_vetIdentidade();
+   }
+   else
+      tc = tabConversao->get_vetConv();
+
    mutacao = new TMutacao(getMapa(), getArqLog(), getMutacao());
    cruzamento = new TCruzamento(getMapa(), getArqLog(), getCruzamento());
    
@@ -106,7 +178,6 @@ void TAlgGenetico::exec(TIndividuo *indBase, TTabConversao *tabConversao, int ex
    if (tam>2*tabConversao->get_quantidade()) tam=2*tabConversao->get_quantidade();
    
    TPopulacao *populacao = new TPopulacao (tam, getMapa(), getArqLog());
-   vector<TTipoConversao> tc = tabConversao->get_vetConv();
    populacao->povoa(tc, extraPadrao);
    melhor = populacao->get_melhor();
    populacao->ordena();
@@ -128,6 +199,8 @@ void TAlgGenetico::exec(TIndividuo *indBase, TTabConversao *tabConversao, int ex
    
    tc.clear();
    delete populacao;
+
+   VP_Mapa = mapaOriginal;
 }
    
 void TAlgGenetico::exec()
@@ -157,10 +230,12 @@ return;
 
    populacao->ordena();
    time(&sysTime1);
+   if (is_registroBinario()) VP_ArqSaida->iniciaRegistros(sysTime1, getMaxGeracao());
 
    for (int i=1; i<=getMaxGeracao(); i++)
    {
       populacao = iteracao (populacao, i);
+      if (VP_ilhas != NULL) VP_ilhas->migra(VP_idIlha, populacao, i);
 	  
       melhor = populacao->get_melhor();	  
 	  if (melhor->get_distancia()<VP_melhor_dist)
@@ -210,11 +285,37 @@ return;
    strFimExec += to_string(getCombinaRec());
    VP_ArqSaida->addLinha(strFimExec);
 
+   if (VP_cache != NULL)
+   {
+      strFimExec = "Qtde de Acertos no Cache da Recursão;";
+      strFimExec += to_string(VP_cache->get_acertos());
+      strFimExec += "; Qtde de Falhas no Cache da Recursão;";
+      strFimExec += to_string(VP_cache->get_falhas());
+      VP_ArqSaida->addLinha(strFimExec);
+      if (getPrintParcial()) cout << strFimExec << endl;
+   }
+
    VP_ArqSaida->addLinha("");
    
    delete populacao;
 }
 
+bool TAlgGenetico::registraGeracao (int geracao, double melhor)
+{
+   bool melhorou = (melhor < VP_melhorRegistrado);
+
+   if (melhorou) VP_melhorRegistrado = melhor;
+
+   if (getNivelLog() < ((get_profundidade() == 0)?nivelGeracoes:nivelTodas)) return false;
+
+   switch (getAmostragemLog())
+   {
+      case amostragemIntervalo: return (geracao == 1)||(geracao % getIntervaloLog() == 0);
+      case amostragemMelhoria:  return melhorou;
+      default:                  return true;
+   }
+}
+
 TPopulacao *TAlgGenetico::iteracao (TPopulacao *populacao, int geracao)
 {
    TPopulacao *novaPop = new TPopulacao(populacao->get_tamanho(), populacao->getMapa(), populacao->getArqLog());
@@ -228,29 +329,50 @@ TPopulacao *TAlgGenetico::iteracao (TPopulacao *populacao, int geracao)
    time(&sysTime2);
    TIndividuo *melhor = novaPop->get_melhor();  
    TIndividuo *pior = novaPop->get_pior();
+   bool registra = registraGeracao(geracao, melhor->get_distancia());
+   string lin;
 
    if (getPrintParcial() && (get_profundidade()==0))
    {
-      string lin = "Geração ";
+      lin = "Geração ";
       lin += to_string (geracao);
       lin += " / ";
       lin += to_string (getMaxGeracao());
       lin += ":";
    
       cout << lin << "(" << get_profundidade() << ") Melhor: " << melhor->get_distancia() << " - Pior: " << pior->get_distancia() << " - Média: " << novaPop->distanciaMedia() << " - Tempo: " << difftime(sysTime2, sysTime1) << endl;
-      VP_ArqSaida->addTexto(lin);	  
    }
 
-   VP_ArqSaida->addTexto(";Profundidade;");
-   VP_ArqSaida->addTexto(to_string (get_profundidade()));
-   VP_ArqSaida->addTexto(";Melhor;");
-   VP_ArqSaida->addTexto(to_string (melhor->get_distancia()));
-   VP_ArqSaida->addTexto(";Pior;");
-   VP_ArqSaida->addTexto(to_string (pior->get_distancia()));
-   VP_ArqSaida->addTexto(";Media;");
-   VP_ArqSaida->addTexto(to_string(novaPop->distanciaMedia()));
-   VP_ArqSaida->addTexto(";Tempo;");
-   VP_ArqSaida->addLinha(to_string(difftime(sysTime2, sysTime1)));
+   if (!registra) return novaPop;
+
+   if (is_registroBinario())
+   {
+      TRegistroGeracao registro;
+
+      registro.melhor       = melhor->get_distancia();
+      registro.pior         = pior->get_distancia();
+      registro.media        = novaPop->distanciaMedia();
+      registro.tempo        = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+      registro.geracao      = geracao;
+      registro.profundidade = get_profundidade();
+      registro.entradas     = getEntradaRec();
+      registro.execucoes    = getExecRec();
+      registro.combinacoes  = getCombinaRec();
+      registro.reservado    = 0;
+      VP_ArqSaida->addRegistro(registro);
+   }
+   else
+   {
+      //A linha inteira numa chamada só: o log é compartilhado entre threads
+      //e chamadas separadas poderiam se intercalar com as de outro AG
+      char campos[512];
+
+      snprintf(campos, sizeof(campos), ";Profundidade;%d;Melhor;%f;Pior;%f;Media;%f;Tempo;%f",
+               get_profundidade(), melhor->get_distancia(), pior->get_distancia(),
+               novaPop->distanciaMedia(), difftime(sysTime2, sysTime1));
+      lin += campos;
+      VP_ArqSaida->addLinha(lin);
+   }
 
    return novaPop;
 }
@@ -277,34 +399,87 @@ void TAlgGenetico::elitismo(TPopulacao *novaPop, TPopulacao *populacao)
 
 void TAlgGenetico::geraDescendentes(TPopulacao *novaPop, TPopulacao *populacao, int geracao)
 {
-   int i;
-   int j;
-   TIndividuo *ind1;
-   TIndividuo *ind2;
+   if (getNumThreads() > 0)
+   {
+      geraDescendentesParalelo(novaPop, populacao, geracao);
+      return;
+   }
 
    TSelecao *selecao = new TSelecao (VP_Mapa, VP_ArqSaida, VP_selecao);
 	
    while (novaPop->get_qtdeIndividuo()<novaPop->get_tamanho())
+      novaPop->add_individuo(geraFilhos(selecao, populacao, geracao));
+	
+	delete selecao;
+}
+
+//Os filhos são gerados em slots independentes. Cada slot tem o seu gerador,
+//semeado com a semente da geração e o número do slot, e os filhos entram na
+//população na ordem dos slots. Assim o resultado é o mesmo para qualquer
+//quantidade de threads
+void TAlgGenetico::geraDescendentesParalelo(TPopulacao *novaPop, TPopulacao *populacao, int geracao)
+{
+   uint64_t semente = TUtils::sorteia();
+   unsigned slot = 0;
+   int falta;
+   int qtdeSlots;
+   int qtdeFilhos;
+   vector <vector <TIndividuo *> > filhos;
+
+   while ((falta = novaPop->get_tamanho() - novaPop->get_qtdeIndividuo()) > 0)
    {
-      i = selecao->processa(populacao);
-      j = selecao->processa(populacao, i);
+      //Quantidade de slots pela média de filhos por cruzamento já observada
+      qtdeSlots = (falta + VP_filhosPorSlot - 1) / VP_filhosPorSlot;
+      filhos.assign(qtdeSlots, vector <TIndividuo *>());
+
+      #pragma omp parallel num_threads(getNumThreads())
+      {
+         TGerador *anterior = TUtils::get_gerador();
+         TGerador gerador;
+         TSelecao *selecao = new TSelecao (VP_Mapa, VP_ArqSaida, VP_selecao);
 
-      ind1 = populacao->get_individuo(i);
-      ind2 = populacao->get_individuo(j);
+         TUtils::set_gerador(&gerador);
 
-      if (ind1->get_distancia()==ind2->get_distancia())
+         #pragma omp for schedule(dynamic)
+         for (int k=0; k<qtdeSlots; k++)
+         {
+            gerador.semeia(semente, slot + k);
+            filhos[k] = geraFilhos(selecao, populacao, geracao);
+         }
+         TUtils::set_gerador(anterior);
+
+         delete selecao;
+      }
+
+      qtdeFilhos = 0;
+      for (int k=0; k<qtdeSlots; k++)
       {
-         ind1 = ind2->clona();
-         novaPop->add_individuo(ind1);
+         qtdeFilhos += filhos[k].size();
+         novaPop->add_individuo(filhos[k]);
       }
-      else
-		{
-			novaPop->add_individuo(cruzamento->processa(ind1, ind2, populacao, getMaxGeracao(), geracao));
-		}
-         
+
+      slot += qtdeSlots;
+      VP_filhosPorSlot = max(1, qtdeFilhos / qtdeSlots);
    }
-	
-	delete selecao;
+}
+
+vector <TIndividuo *>TAlgGenetico::geraFilhos(TSelecao *selecao, TPopulacao *populacao, int geracao)
+{
+   int i;
+   int j;
+   TIndividuo *ind1;
+   TIndividuo *ind2;
+
+   i = selecao->processa(populacao);
+   j = selecao->processa(populacao, i);
+
+   ind1 = populacao->get_individuo(i);
+   ind2 = populacao->get_individuo(j);
+
+   if (ind1->get_distancia()==ind2->get_distancia())
+      return vector <TIndividuo *>(1, ind2->clona());
+
+   return cruzamento->processa(ind1, ind2, populacao, getMaxGeracao(), geracao);
 }
 
 void TAlgGenetico::fazMutacao(TPopulacao *populacao)
@@ -335,58 +510,266 @@ void TAlgGenetico::fazMutacao(TPopulacao *populacao)
       }
    }
 
-   for (int i=0; i < qtdeMutacao; i++)
+   if (getNumThreads() > 0)
+      mutacaoParalela(populacao, ini, qtdeMutacao);
+   else
    {
-      int j = TUtils::rnd (ini, populacao->get_tamanho()-1);
+      for (int i=0; i < qtdeMutacao; i++)
+      {
+         int j = TUtils::rnd (ini, populacao->get_tamanho()-1);
 
-      populacao->sub_dist_tot((populacao->get_individuo(j))->get_distancia());
+         populacao->sub_dist_tot((populacao->get_individuo(j))->get_distancia());
 
-      mutacao->processa(populacao->get_individuo(j));
+         mutacao->processa(populacao->get_individuo(j));
 
-      populacao->soma_dist_tot((populacao->get_individuo(j))->get_distancia());
+         populacao->soma_dist_tot((populacao->get_individuo(j))->get_distancia());
+      }
    }
 
-   for (int i=0; i < qtdeMutacaoRecursiva; i++)
+   if (getTarefasRecursivas() > 0)
+      mutacaoRecursivaParalela(populacao, qtdeMutacaoRecursiva);
+   else
    {
-      int j = TUtils::rnd (1, populacao->get_tamanho()-1);
+      for (int i=0; i < qtdeMutacaoRecursiva; i++)
+      {
+         int j = TUtils::rnd (1, populacao->get_tamanho()-1);
 
-      populacao->sub_dist_tot((populacao->get_individuo(j))->get_distancia());
+         populacao->sub_dist_tot((populacao->get_individuo(j))->get_distancia());
 
-      mutacaoAGRecursivo(populacao, j);
+         mutacaoAGRecursivo(populacao, j);
 
-      populacao->soma_dist_tot((populacao->get_individuo(j))->get_distancia());
+         populacao->soma_dist_tot((populacao->get_individuo(j))->get_distancia());
+      }
    }
 	
 }
 
+//As vítimas são sorteadas antes e cada indivíduo fica com uma única thread:
+//mutações repetidas no mesmo indivíduo são feitas em sequência, na ordem do
+//sorteio. Cada mutação tem o seu gerador (semente da geração + número da
+//mutação) e as somas da população são acertadas no fim, na ordem das vítimas
+void TAlgGenetico::mutacaoParalela(TPopulacao *populacao, int ini, int qtdeMutacao)
+{
+   if (qtdeMutacao <= 0) return;
+
+   uint64_t semente = TUtils::sorteia();
+   vector <int> vitimas;
+   vector <vector <unsigned> > mutacoes(populacao->get_tamanho());
+   vector <double> distAnt;
+
+   for (int i=0; i < qtdeMutacao; i++)
+   {
+      int j = TUtils::rnd (ini, populacao->get_tamanho()-1);
+
+      if (mutacoes[j].empty()) vitimas.push_back(j);
+      mutacoes[j].push_back(i);
+   }
+
+   distAnt.resize(vitimas.size());
+   for (unsigned k=0; k < vitimas.size(); k++)
+      distAnt[k] = populacao->get_individuo(vitimas[k])->get_distancia();
+
+   #pragma omp parallel for schedule(dynamic) num_threads(getNumThreads())
+   for (int k=0; k < (int)vitimas.size(); k++)
+   {
+      TIndividuo *individuo = populacao->get_individuo(vitimas[k]);
+      vector <unsigned> &lista = mutacoes[vitimas[k]];
+      TGerador *anterior = TUtils::get_gerador();
+      TGerador gerador;
+
+      TUtils::set_gerador(&gerador);
+      for (unsigned m=0; m < lista.size(); m++)
+      {
+         gerador.semeia(semente, lista[m]);
+         mutacao->processa(individuo);
+      }
+      TUtils::set_gerador(anterior);
+   }
+
+   for (unsigned k=0; k < vitimas.size(); k++)
+   {
+      populacao->sub_dist_tot(distAnt[k]);
+      populacao->soma_dist_tot(populacao->get_individuo(vitimas[k])->get_distancia());
+   }
+}
+
 void TAlgGenetico::mutacaoAGRecursivo(TPopulacao *populacao, int indice)
 {
-	VP_Entr_Rec++;
+   if (recursao(populacao->get_melhor(), populacao->get_individuo(indice), populacao->get_tamanho(),
+                VP_mapaFilhos, NULL))
+      populacao->troca(0, indice);
+}
+
+//Execução especulativa: cada mutação vira uma tarefa, que trabalha em cópias
+//da vítima e do melhor. As tarefas (e as recursões delas) são distribuídas
+//entre as threads pelo escalonador do OpenMP. Depois, na ordem do sorteio,
+//uma tarefa só é aproveitada se o melhor, a vítima e o cache ainda estão
+//como ela viu; senão ela é refeita na rodada seguinte. Assim cada mutação
+//compara com o melhor da vez, como no modo serial, e o resultado não
+//depende da quantidade de threads
+void TAlgGenetico::mutacaoRecursivaParalela(TPopulacao *populacao, int qtdeMutacao)
+{
+   if (qtdeMutacao <= 0) return;
+
+   uint64_t semente = TUtils::sorteia();
+   vector <int> vitimas(qtdeMutacao);
+   int primeira = 0;
+
+   for (int i=0; i < qtdeMutacao; i++)
+      vitimas[i] = TUtils::rnd (1, populacao->get_tamanho()-1);
+
+   while (primeira < qtdeMutacao)
+   {
+      vector <TTarefaRecursiva> tarefas;
+      vector <bool> sorteado(populacao->get_tamanho(), false);
+      TIndividuo *melhor = populacao->get_melhor()->clona();
+      TIndividuo *individuo;
+      unsigned aceitas;
+
+      //A rodada vai até a primeira vítima repetida, que com certeza
+      //teria de ser refeita, e no máximo getTarefasRecursivas() tarefas,
+      //para limitar o trabalho perdido quando o melhor muda
+      for (int i=primeira; (i < qtdeMutacao)&&(i < primeira+getTarefasRecursivas())&&(!sorteado[vitimas[i]]); i++)
+      {
+         TTarefaRecursiva t;
+
+         sorteado[vitimas[i]] = true;
+         t.indice      = vitimas[i];
+         t.mutacao     = i;
+         t.manipulado  = populacao->get_individuo(vitimas[i])->clona();
+         t.log         = new TArqLog();
+         t.melhorou    = false;
+         t.entradas    = 0;
+         t.execucoes   = 0;
+         t.combinacoes = 0;
+         tarefas.push_back(t);
+      }
+
+      while (VP_mapasTarefas.size() < tarefas.size()) VP_mapasTarefas.push_back(NULL);
+
+      //Já dentro de uma tarefa (recursão aninhada) as novas tarefas entram no
+      //mesmo grupo de threads; no nível de cima o grupo é criado aqui
+      if (get_profundidade() > 0)
+         disparaTarefas(tarefas, melhor, populacao->get_tamanho(), semente);
+      else
+      {
+         #pragma omp parallel num_threads(getNumThreads())
+         #pragma omp single
+         disparaTarefas(tarefas, melhor, populacao->get_tamanho(), semente);
+      }
+
+      for (aceitas=0; aceitas < tarefas.size(); aceitas++)
+      {
+         TTarefaRecursiva &t = tarefas[aceitas];
+         vector <int> ordem;
+
+         if (!tarefaValida(t)) break;
+
+         individuo = populacao->get_individuo(t.indice);
+         populacao->sub_dist_tot(individuo->get_distancia());
+         *individuo = *t.manipulado;
+         populacao->soma_dist_tot(individuo->get_distancia());
+
+         t.log->descarrega(getArqLog());
+
+         //Ordem vazia: acerto durante a tarefa
+         for (unsigned c=0; c < t.cache.size(); c++)
+         {
+            if (!VP_cache->busca(t.cache[c].first, ordem))
+               VP_cache->guarda(t.cache[c].first, t.cache[c].second);
+         }
+
+         VP_Entr_Rec += t.entradas;
+         VP_Exec_Rec += t.execucoes;
+         VP_Comb_Rec += t.combinacoes;
+
+         //O melhor mudou: as tarefas seguintes compararam com o antigo
+         if (t.melhorou)
+         {
+            populacao->troca(0, t.indice);
+            aceitas++;
+            break;
+         }
+      }
+
+      for (unsigned k=0; k < tarefas.size(); k++)
+      {
+         delete tarefas[k].manipulado;
+         delete tarefas[k].log;
+      }
+      delete melhor;
+
+      primeira += aceitas;
+   }
+}
+
+//Confere se o cache ainda responde como respondeu para a tarefa
+bool TAlgGenetico::tarefaValida(TTarefaRecursiva &tarefa)
+{
+   vector <int> ordem;
+
+   for (unsigned c=0; c < tarefa.cache.size(); c++)
+   {
+      if (VP_cache->consulta(tarefa.cache[c].first, ordem) != tarefa.cache[c].second.empty())
+         return false;
+   }
+   return true;
+}
+
+void TAlgGenetico::disparaTarefas(vector <TTarefaRecursiva> &tarefas, TIndividuo *melhor,
+                                  unsigned tamPopulacao, uint64_t semente)
+{
+   for (unsigned k=0; k < tarefas.size(); k++)
+   {
+      #pragma omp task firstprivate(k) shared(tarefas)
+      {
+         TTarefaRecursiva &t = tarefas[k];
+         TGerador *anterior = TUtils::get_gerador();
+         TGerador gerador(semente, t.mutacao);
+
+         TUtils::set_gerador(&gerador);
+         t.melhorou = recursao(melhor, t.manipulado, tamPopulacao, VP_mapasTarefas[k], &t);
+         TUtils::set_gerador(anterior);
+      }
+   }
+   #pragma omp taskwait
+}
+
+bool TAlgGenetico::recursao(TIndividuo *melhor, TIndividuo *manipulado, unsigned tamPopulacao,
+                            TMapaGenes *&mapaFilhos, TTarefaRecursiva *tarefa)
+{
+   //Numa tarefa, o log e os contadores são os dela
+   TArqLog *log       = (tarefa != NULL)?tarefa->log:getArqLog();
+   unsigned &entradas = (tarefa != NULL)?tarefa->entradas:VP_Entr_Rec;
+   unsigned &execucoes = (tarefa != NULL)?tarefa->execucoes:VP_Exec_Rec;
+   unsigned &combinacoes = (tarefa != NULL)?tarefa->combinacoes:VP_Comb_Rec;
+
+	entradas++;
 
    //Tranosformará as sequências, do indivíduo, que coincidem com o melhor em um gene
    TTabConversao *tabConversao;
 
    int qtdeGenes;
+   int livres;
    long esforco;
-   long fatorial;
-
-   TIndividuo *melhor = populacao->get_melhor();
-   TIndividuo *manipulado = populacao->get_individuo(indice);
+   long custoExato;
+   bool melhorou = false;
 
    //Verifico se o esforço
    //(poulação (cruzamento + elitismo))* Número de gerações * (população * %mutação)
-   esforco = (populacao->get_tamanho() * getPercentMutacao()/100) * getMaxGeracao() * populacao->get_tamanho();
+   esforco = (tamPopulacao * getPercentMutacao()/100) * getMaxGeracao() * tamPopulacao;
 
-   //So o fatorial for <= 0 é porque houve overflow
+   //Custo da solução exata (Held-Karp): n² 2^n, com n = genes livres
    //-1, pois como é um ciclo, é possível fixar o 0
-   fatorial = TUtils::fatorialStirling(manipulado->get_qtdeGenes()-1);
+   livres = manipulado->get_qtdeGenes()-1;
+   custoExato = (livres<=TIndividuo::limiteMelhorPossivel)?(long)livres*livres*(1L<<livres):-1;
 
-   //é maior do que todas as combinações (fatorial) da quantidade de gene
-   //Se a combinação for maior, realiza o AG com os novos genes.
-   //Obs.: o fatorial deve ser > 0, pois provavelmente irá estourar o long
-   if ((fatorial>0)&&(esforco>=fatorial))
+   //é maior do que o custo da solução exata para a quantidade de genes
+   //Se for menor, realiza o AG com os novos genes.
+   //Obs.: acima do limite a tabela do melhorPossivel ficaria grande demais
+   if ((custoExato>=0)&&(esforco>=custoExato))
    {
-   	VP_Comb_Rec++;
+      combinacoes++;
 		
       //Quando o esforço é maior que as combinações
       //O melhor indivuo por combinação
@@ -394,12 +777,12 @@ void TAlgGenetico::mutacaoAGRecursivo(TPopulacao *populacao, int indice)
 
 		if (manipulado->get_distancia()<melhor->get_distancia())
       {
-         populacao->troca(0, indice);
+         melhorou = true;
 
 			if(getPrintParcial()) cout << "Melhorou na combinação" << endl;
-         VP_ArqSaida->addLinha ("Melhorou na combinação");
+         if (getNivelLog() >= nivelMelhorias) log->addLinha ("Melhorou na combinação");
 		}
-      return;
+      return melhorou;
    }
 
    do
@@ -426,39 +809,78 @@ void TAlgGenetico::mutacaoAGRecursivo(TPopulacao *populacao, int indice)
    {
       //Libera memória
       delete tabConversao;
-      return;
+      return melhorou;
    }
    
-	VP_Exec_Rec++;
-   //Executando o AG recursivamente
-   TAlgGenetico *ag = new TAlgGenetico(getMapa(), getArqLog(), get_profundidade()+1);
-   ag->setMutacao(getMutacao());
-   ag->setCruzamento(getCruzamento());
-   ag->setTamPopulacao(getTamPopulacao());
-   ag->setPrintParcial(getPrintParcial());
-   ag->setMaxGeracao(getMaxGeracao());
-   ag->setPercentElitismo(getPercentElitismo());
-   ag->setPercentMutacao(getPercentMutacao());
-   ag->setProfundidadeMaxima(getProfundidadeMaxima());
-   ag->setSelecao(getSelecao());
-   ag->setSelIndMutacao(getSelIndMutacao());
-   ag->setPercentMutacaoRecursiva(getPercentMutacaoRecursiva());
-   ag->setPercentReducao(getPercentReducao());
-   ag->setTime(sysTime1);
-   ag->exec(manipulado, tabConversao, melhor->get_extra());
-
-   VP_Entr_Rec += ag->getEntradaRec();
-	VP_Exec_Rec += ag->getExecRec();
-	VP_Comb_Rec += ag->getCombinaRec();
+   //No nível 0 o mapa é sempre o mesmo, então uma tabela de fragmentos
+   //já resolvida pode ser reaproveitada sem executar o AG. Nas tarefas
+   //o cache só é lido; as alterações ficam pendentes até a tarefa ser aceita
+   string chave;
+   vector<int> ordem;
+   bool usaCache = (VP_cache != NULL)&&(get_profundidade() == 0);
+   bool acerto = false;
+
+   if (usaCache)
+   {
+      chave = TCacheRecursao::chave(tabConversao);
+      if (tarefa == NULL) acerto = VP_cache->busca(chave, ordem);
+      else acerto = VP_cache->consulta(chave, ordem);
+      if (acerto) tabConversao->converte(manipulado, ordem);
+   }
+
+   if (!acerto)
+   {
+      execucoes++;
+      //Executando o AG recursivamente
+      TAlgGenetico *ag = new TAlgGenetico(getMapa(), log, get_profundidade()+1);
+      ag->setMutacao(getMutacao());
+      ag->setCruzamento(getCruzamento());
+      ag->setTamPopulacao(getTamPopulacao());
+      ag->setPrintParcial(getPrintParcial());
+      ag->setMaxGeracao(getMaxGeracao());
+      ag->setPercentElitismo(getPercentElitismo());
+      ag->setPercentMutacao(getPercentMutacao());
+      ag->setProfundidadeMaxima(getProfundidadeMaxima());
+      ag->setSelecao(getSelecao());
+      ag->setSelIndMutacao(getSelIndMutacao());
+      ag->setPercentMutacaoRecursiva(getPercentMutacaoRecursiva());
+      ag->setPercentReducao(getPercentReducao());
+      ag->setTarefasRecursivas(getTarefasRecursivas());
+      ag->setRegistroBinario(is_registroBinario());
+      ag->setNivelLog(getNivelLog());
+      ag->setAmostragemLog(getAmostragemLog());
+      ag->setIntervaloLog(getIntervaloLog());
+      ag->setTime(sysTime1);
+      if (mapaFilhos == NULL) mapaFilhos = new TMapaGenes();
+      ag->setMapaReduzido(mapaFilhos);
+      ag->exec(manipulado, tabConversao, melhor->get_extra());
+
+      entradas    += ag->getEntradaRec();
+      execucoes   += ag->getExecRec();
+      combinacoes += ag->getCombinaRec();
+      delete ag;
+
+      if (usaCache)
+      {
+         if (tarefa == NULL) VP_cache->guarda(chave, tabConversao->get_ordem(manipulado));
+         else tarefa->cache.push_back(make_pair(chave, tabConversao->get_ordem(manipulado)));
+      }
+   }
+   else if (tarefa != NULL)
+      tarefa->cache.push_back(make_pair(chave, vector<int>()));
 
    if (manipulado->get_distancia()<melhor->get_distancia())
    {
-      populacao->troca(0, indice);
-      string lin = "Melhorou profundidade ;";
-	  
-	  lin += to_string(get_profundidade()+1);
-	  if (getPrintParcial()) cout << endl << lin << endl;
-	  VP_ArqSaida->addLinha(lin);
+      melhorou = true;
+
+      if (getPrintParcial() || (getNivelLog() >= nivelMelhorias))
+      {
+         string lin = "Melhorou profundidade ;";
+
+         lin += to_string(get_profundidade()+1);
+         if (getPrintParcial()) cout << endl << lin << endl;
+         if (getNivelLog() >= nivelMelhorias) log->addLinha(lin);
+      }
    }
    else if (manipulado->get_distancia()==melhor->get_distancia())
    {
@@ -475,4 +897,5 @@ void TAlgGenetico::mutacaoAGRecursivo(TPopulacao *populacao, int indice)
    
    //Libera memória
    delete tabConversao;
+   return melhorou;
 }
@@ -22,10 +22,25 @@
 #include "populacao.hpp"
 #include "utils.hpp"
 #include "tabconversao.hpp"
+#include "cacherecursao.hpp"
 
 
+class TIlhas;
+
 class TAlgGenetico
 {
+   public:
+      //Nível de log: cada nível inclui os anteriores
+      static const int nivelResumo    = 0;  //só o resumo do fim da execução
+      static const int nivelGeracoes  = 1;  //gerações da profundidade 0
+      static const int nivelMelhorias = 2;  //melhorias obtidas na recursão
+      static const int nivelTodas     = 3;  //gerações de todas as profundidades
+
+      //Amostragem das gerações que passaram pelo nível
+      static const int amostragemTodas     = 0;
+      static const int amostragemIntervalo = 1;  //a cada intervaloLog gerações
+      static const int amostragemMelhoria  = 2;  //só quando o melhor melhora
+
    private:
       time_t sysTime1;
       time_t sysTime2;
@@ -44,6 +59,31 @@ class TAlgGenetico
       int VP_percentReducao;
       int VP_profundidadeMaxima;
       int VP_percentMutacaoRecursiva;
+      int VP_numThreads;
+      bool VP_registroBinario;  //gerações no .trc, no lugar do log texto
+      int VP_filhosPorSlot;
+      int VP_tarefasRecursivas;  //mutações recursivas especuladas de uma vez (0: serial)
+      int VP_nivelLog;
+      int VP_amostragemLog;
+      int VP_intervaloLog;
+      double VP_melhorRegistrado;  //para a amostragem por melhoria
+
+      //Mutação recursiva executada em uma tarefa, sobre uma cópia da vítima
+      struct TTarefaRecursiva
+      {
+         int indice;                                    //vítima na população
+         int mutacao;                                   //número da mutação na geração
+         TIndividuo *manipulado;
+         bool melhorou;
+         TArqLog *log;                                  //log em memória
+         vector <pair <string, vector<int> > > cache;  //pendências (ordem vazia: acerto)
+         unsigned entradas;
+         unsigned execucoes;
+         unsigned combinacoes;
+      };
+
+      //Mapas reduzidos das tarefas, reaproveitados a cada geração
+      vector <TMapaGenes *> VP_mapasTarefas;
 
       double VP_melhor_dist;
 	   int VP_melhor_gera;
@@ -51,6 +91,18 @@ class TAlgGenetico
       TMapaGenes *VP_Mapa;
       TArqLog *VP_ArqSaida;
 
+      //Mapa denso dos fragmentos, usado no exec recursivo. Pertence ao AG pai,
+      //que o reaproveita a cada recursão (VP_mapaFilhos)
+      TMapaGenes *VP_mapaReduzido;
+      TMapaGenes *VP_mapaFilhos;
+
+      //Ordens já encontradas para as tabelas de fragmentos (apenas nível 0)
+      TCacheRecursao *VP_cache;
+
+      //Modelo de ilhas: NULL quando o AG roda sozinho
+      TIlhas *VP_ilhas;
+      int VP_idIlha;
+
 		unsigned VP_Comb_Rec;
       unsigned VP_Entr_Rec;
 		unsigned VP_Exec_Rec;
@@ -84,6 +136,12 @@ class TAlgGenetico
       void setPercentReducao (int val);
 	   void setProfundidadeMaxima(int val);
       void setPercentMutacaoRecursiva (int val);
+      void setNumThreads (int val);
+      void setRegistroBinario (bool val);
+      void setTarefasRecursivas (int val);
+      void setNivelLog (int val);
+      void setAmostragemLog (int val);
+      void setIntervaloLog (int val);
 
       int getPercentReducao ();
 	   int getProfundidadeMaxima();
@@ -98,8 +156,18 @@ class TAlgGenetico
       int getPercentElitismo ();
       int getSelecao ();
       int getSelIndMutacao ();
+      int getNumThreads ();
+      bool is_registroBinario ();
+      int getTarefasRecursivas ();
+      int getNivelLog ();
+      int getAmostragemLog ();
+      int getIntervaloLog ();
 
       void setTime (time_t sTime);
+      void setMapaReduzido (TMapaGenes *mapa);
+      //Quantidade de subproblemas guardados (0 desliga)
+      void setTamCacheRecursao (int val);
+      void setIlha (TIlhas *ilhas, int id);
       //Métodos
       TAlgGenetico (TMapaGenes *mapa, TArqLog *arqSaida, int profundidade);
 		TAlgGenetico (TMapaGenes *mapa, TArqLog *arqSaida);
@@ -109,10 +177,24 @@ class TAlgGenetico
       void exec ();
 
       TPopulacao *iteracao (TPopulacao *populacao, int geracao);
+      //Se a geração vai para o log, pelo nível e pela amostragem. Decidido
+      //antes de montar qualquer texto
+      bool registraGeracao (int geracao, double melhor);
       void elitismo(TPopulacao *novaPop, TPopulacao *populacao);
       void geraDescendentes(TPopulacao *novaPop, TPopulacao *populacao, int geracao);
+      void geraDescendentesParalelo(TPopulacao *novaPop, TPopulacao *populacao, int geracao);
+      vector <TIndividuo *>geraFilhos(TSelecao *selecao, TPopulacao *populacao, int geracao);
       void fazMutacao(TPopulacao *populacao);
+      void mutacaoParalela(TPopulacao *populacao, int ini, int qtdeMutacao);
       void mutacaoAGRecursivo(TPopulacao *populacao, int indice);
+      void mutacaoRecursivaParalela(TPopulacao *populacao, int qtdeMutacao);
+      void disparaTarefas(vector <TTarefaRecursiva> &tarefas, TIndividuo *melhor,
+                          unsigned tamPopulacao, uint64_t semente);
+      bool tarefaValida(TTarefaRecursiva &tarefa);
+      //Mutação recursiva de manipulado em relação a melhor. Retorna true se
+      //manipulado ficou melhor. Numa tarefa, o cache não é alterado
+      bool recursao(TIndividuo *melhor, TIndividuo *manipulado, unsigned tamPopulacao,
+                    TMapaGenes *&mapaFilhos, TTarefaRecursiva *tarefa);
 };
 
 #endif
@@ -11,25 +11,179 @@
 */
 
 #include "arqlog.hpp"
+#include <cstring>
+#include <cstdio>
 
 TArqLog::TArqLog(string cabecalho, string path)
 {
+   VP_memoria = false;
+   VP_fim = false;
    VP_Path = path;
    fl.open (VP_Path, std::fstream::out);
+   VP_conteudo.reserve(limiteBuffer);
+   VP_gravando.reserve(limiteBuffer);
    addLinha (cabecalho);
+   VP_escritor = thread(&TArqLog::escritor, this);
+}
+
+TArqLog::TArqLog()
+{
+   VP_memoria = true;
+   VP_fim = false;
 }
 
 TArqLog::~TArqLog()
 {
-   fl.close();
+   if (!VP_memoria)
+   {
+      {
+         lock_guard<mutex> trava(VP_trava);
+         VP_fim = true;
+      }
+      VP_aviso.notify_one();
+      VP_escritor.join();
+      fl.close();
+      if (VP_flRegistros.is_open()) VP_flRegistros.close();
+   }
+}
+
+void TArqLog::escritor ()
+{
+   unique_lock<mutex> trava(VP_trava);
+
+   while (true)
+   {
+      VP_aviso.wait_for(trava, chrono::milliseconds(intervaloDescarga),
+                        [this]{ return VP_fim || (VP_conteudo.size() >= limiteBuffer) ||
+                                       (VP_registros.size() >= limiteBuffer); });
+
+      if (!VP_conteudo.empty() || !VP_registros.empty())
+      {
+         //Troca os buffers e grava fora da trava
+         VP_gravando.swap(VP_conteudo);
+         VP_gravandoRegistros.swap(VP_registros);
+         trava.unlock();
+         if (!VP_gravando.empty())
+         {
+            fl.write(VP_gravando.data(), VP_gravando.size());
+            fl.flush();
+         }
+         if (!VP_gravandoRegistros.empty())
+         {
+            VP_flRegistros.write(VP_gravandoRegistros.data(), VP_gravandoRegistros.size());
+            VP_flRegistros.flush();
+         }
+         VP_gravando.clear();
+         VP_gravandoRegistros.clear();
+         trava.lock();
+      }
+      else if (VP_fim) break;
+   }
+}
+
+void TArqLog::acrescenta (const char *texto, size_t tam, bool registro, bool fimLinha)
+{
+   string &buffer = registro?VP_registros:VP_conteudo;
+
+   if (VP_memoria)
+   {
+      buffer.append(texto, tam);
+      if (fimLinha) buffer += '\n';
+      return;
+   }
+
+   bool cheio;
+   {
+      lock_guard<mutex> trava(VP_trava);
+      buffer.append(texto, tam);
+      if (fimLinha) buffer += '\n';
+      cheio = (buffer.size() >= limiteBuffer);
+   }
+   if (cheio) VP_aviso.notify_one();
+}
+
+void TArqLog::addLinha (const string &linha) { acrescenta(linha.data(), linha.size(), false, true); }
+void TArqLog::addLinha (const char *linha)   { acrescenta(linha, strlen(linha), false, true); }
+
+void TArqLog::addTexto (const string &texto) { acrescenta(texto.data(), texto.size()); }
+void TArqLog::addTexto (const char *texto)   { acrescenta(texto, strlen(texto)); }
+
+void TArqLog::addTexto (int val)
+{
+   char buf[32];
+   acrescenta(buf, snprintf(buf, sizeof(buf), "%d", val));
+}
+
+void TArqLog::addTexto (unsigned val)
+{
+   char buf[32];
+   acrescenta(buf, snprintf(buf, sizeof(buf), "%u", val));
+}
+
+void TArqLog::addTexto (long val)
+{
+   char buf[32];
+   acrescenta(buf, snprintf(buf, sizeof(buf), "%ld", val));
+}
+
+void TArqLog::addTexto (unsigned long val)
+{
+   char buf[32];
+   acrescenta(buf, snprintf(buf, sizeof(buf), "%lu", val));
+}
+
+void TArqLog::addTexto (double val)
+{
+   char buf[512];
+   acrescenta(buf, snprintf(buf, sizeof(buf), "%f", val));
+}
+
+void TArqLog::descarrega (TArqLog *destino)
+{
+   destino->addTexto(VP_conteudo);
+   VP_conteudo.clear();
+
+   if (!VP_registros.empty() && (destino->VP_memoria || destino->VP_flRegistros.is_open()))
+      destino->acrescenta(VP_registros.data(), VP_registros.size(), true);
+   VP_registros.clear();
 }
-void TArqLog::addLinha (string linha)
+
+void TArqLog::abreRegistros ()
 {
-   addTexto(linha);
-   fl << endl;
+   string path = VP_Path;
+
+   if ((path.size() > 4)&&(path.compare(path.size()-4, 4, ".txt") == 0)) path.erase(path.size()-4);
+   path += ".trc";
+
+   lock_guard<mutex> trava(VP_trava);
+   VP_flRegistros.open(path, std::fstream::out | std::fstream::binary);
+   if (!VP_flRegistros.is_open())
+      printf("Erro ao criar o arquivo de registros %s\n", path.c_str());
 }
 
-void TArqLog::addTexto (string texto)
+void TArqLog::iniciaRegistros (time_t inicioExecucao, int maxGeracao)
 {
-   fl << texto;
+   TCabecalhoRegistros cabecalho;
+
+   if (VP_memoria || !VP_flRegistros.is_open()) return;
+
+   memset(&cabecalho, 0, sizeof(cabecalho));
+   memcpy(cabecalho.assinatura, assinaturaRegistros, sizeof(cabecalho.assinatura));
+   cabecalho.inicio = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+   cabecalho.inicioReal = chrono::duration_cast<chrono::nanoseconds>(chrono::system_clock::now().time_since_epoch()).count();
+   cabecalho.inicioExecucao = inicioExecucao;
+   cabecalho.maxGeracao = maxGeracao;
+   cabecalho.tamRegistro = sizeof(TRegistroGeracao);
+
+   //Ainda não há registros: a thread de gravação não usa o arquivo
+   lock_guard<mutex> trava(VP_trava);
+   VP_flRegistros.write((const char *)&cabecalho, sizeof(cabecalho));
+}
+
+void TArqLog::addRegistro (const TRegistroGeracao &registro)
+{
+   //Num log em arquivo, só se o arquivo de registros foi criado
+   if (!VP_memoria && !VP_flRegistros.is_open()) return;
+
+   acrescenta((const char *)&registro, sizeof(registro), true);
 }
@@ -16,20 +16,74 @@
 
 #include <string>
 #include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <ctime>
+#include "registro.hpp"
 
 using namespace std;
 
+//As linhas são acumuladas em memória e gravadas por uma thread própria do
+//log, quando o buffer passa de limiteBuffer ou a cada intervaloDescarga.
+//Enquanto um buffer é gravado, o outro recebe as novas linhas. Pode ser
+//compartilhado entre threads. Os registros binários das gerações, quando
+//ativados, vão para um segundo arquivo, pelo mesmo caminho
 class TArqLog
 {
    private:
+      static const size_t limiteBuffer      = 1 << 20;  //bytes
+      static const int    intervaloDescarga = 1000;     //ms
+
       fstream fl;
       string VP_Path;
 
+      //Log em memória, sem arquivo
+      bool VP_memoria;
+      string VP_conteudo;
+
+      string VP_gravando;  //buffer entregue à thread de gravação
+
+      fstream VP_flRegistros;
+      string VP_registros;
+      string VP_gravandoRegistros;
+      bool VP_fim;
+      mutex VP_trava;
+      condition_variable VP_aviso;
+      thread VP_escritor;
+
+      void escritor ();
+      //Uma trava por chamada; com fimLinha, o texto e o \n entram juntos
+      void acrescenta (const char *texto, size_t tam, bool registro = false, bool fimLinha = false);
+
    public:
       TArqLog(string cabecalho, string path);
+      //Log em memória, para ser descarregado depois em outro log. Usado
+      //pelas tarefas paralelas; não é protegido, pois tem um único dono
+      TArqLog();
+      //Grava o que falta e encerra a thread de gravação
       ~TArqLog();
-      void addLinha (string linha);
-      void addTexto (string texto);
+      //Cada chamada entra inteira no log, sem se intercalar com a de outra
+      //thread. Uma linha montada por vários addTexto pode se intercalar:
+      //com o log compartilhado, monte a linha e use um único addLinha
+      void addLinha (const string &linha);
+      void addLinha (const char *linha);
+      void addTexto (const string &texto);
+      void addTexto (const char *texto);
+      //Números, formatados como no to_string, sem string temporária
+      void addTexto (int val);
+      void addTexto (unsigned val);
+      void addTexto (long val);
+      void addTexto (unsigned long val);
+      void addTexto (double val);
+      void descarrega (TArqLog *destino);
+
+      //Cria o arquivo de registros binários, com o nome do log trocando
+      //.txt por .trc. Sem ele, addRegistro não grava nada
+      void abreRegistros ();
+      //Grava o cabeçalho, no início do AG (sysTime1), antes dos registros
+      void iniciaRegistros (time_t inicioExecucao, int maxGeracao);
+      void addRegistro (const TRegistroGeracao &registro);
 };
 
 #endif
@@ -0,0 +1,99 @@
+/*
+*  cacherecursao.cpp
+*
+*  Módulo responsável pela memória dos subproblemas da recursão.
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 16/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#include "cacherecursao.hpp"
+
+TCacheRecursao::TCacheRecursao(unsigned capacidade)
+{
+   VP_capacidade = capacidade;
+   VP_acertos = 0;
+   VP_falhas = 0;
+}
+
+TCacheRecursao::~TCacheRecursao()
+{
+   VP_indice.clear();
+   VP_itens.clear();
+}
+
+unsigned long TCacheRecursao::get_acertos() { return VP_acertos; }
+unsigned long TCacheRecursao::get_falhas()  { return VP_falhas; }
+
+string TCacheRecursao::chave(TTabConversao *tabConversao)
+{
+   vector<TTipoConversao> tc = tabConversao->get_vetConv();
+   string resultado;
+
+   //O primeiro e o último gene de cada fragmento definem também o sentido
+   resultado.reserve(tc.size()*2*sizeof(int));
+   for (unsigned i=0; i<tc.size(); i++)
+   {
+      resultado.append((const char *) &tc[i].pr, sizeof(int));
+      resultado.append((const char *) &tc[i].ul, sizeof(int));
+   }
+   return resultado;
+}
+
+bool TCacheRecursao::busca(const string &chave, vector<int> &ordem)
+{
+   unordered_map<string, list<TItemCache>::iterator>::iterator it = VP_indice.find(chave);
+
+   if (it == VP_indice.end())
+   {
+      VP_falhas++;
+      return false;
+   }
+
+   //Passa a ser o mais recente
+   VP_itens.splice(VP_itens.begin(), VP_itens, it->second);
+   ordem = it->second->ordem;
+   VP_acertos++;
+   return true;
+}
+
+bool TCacheRecursao::consulta(const string &chave, vector<int> &ordem) const
+{
+   unordered_map<string, list<TItemCache>::iterator>::const_iterator it = VP_indice.find(chave);
+
+   if (it == VP_indice.end()) return false;
+
+   ordem = it->second->ordem;
+   return true;
+}
+
+void TCacheRecursao::guarda(const string &chave, const vector<int> &ordem)
+{
+   unordered_map<string, list<TItemCache>::iterator>::iterator it;
+
+   if (VP_capacidade == 0) return;
+
+   it = VP_indice.find(chave);
+   if (it != VP_indice.end())
+   {
+      it->second->ordem = ordem;
+      VP_itens.splice(VP_itens.begin(), VP_itens, it->second);
+      return;
+   }
+
+   //Cheio: descarta o usado há mais tempo
+   if (VP_itens.size() >= VP_capacidade)
+   {
+      VP_indice.erase(VP_itens.back().chave);
+      VP_itens.pop_back();
+   }
+
+   TItemCache item;
+   item.chave = chave;
+   item.ordem = ordem;
+   VP_itens.push_front(item);
+   VP_indice[chave] = VP_itens.begin();
+}
@@ -0,0 +1,61 @@
+/*
+*  cacherecursao.hpp
+*
+*  Módulo responsável pela memória dos subproblemas da recursão.
+*  Guarda, para cada tabela de fragmentos, a ordem encontrada pelo AG
+*  recursivo, descartando a usada há mais tempo (LRU)
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 16/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#ifndef _CACHERECURSAO_H
+#define	_CACHERECURSAO_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include "tabconversao.hpp"
+
+using namespace std;
+
+class TCacheRecursao
+{
+   private:
+      struct TItemCache
+      {
+         string chave;
+         vector<int> ordem;
+      };
+
+      //Mais recente no início da lista
+      list<TItemCache> VP_itens;
+      unordered_map<string, list<TItemCache>::iterator> VP_indice;
+      unsigned VP_capacidade;
+
+      unsigned long VP_acertos;
+      unsigned long VP_falhas;
+
+   public:
+      TCacheRecursao(unsigned capacidade);
+      ~TCacheRecursao();
+
+      //Chave canônica: os extremos de cada fragmento, na ordem da tabela
+      static string chave(TTabConversao *tabConversao);
+
+      //Se a tabela já foi resolvida, devolve a ordem dos fragmentos
+      bool busca(const string &chave, vector<int> &ordem);
+      //Como a busca, mas sem mexer na ordem de uso nem nos contadores.
+      //Pode ser chamada por várias threads, desde que ninguém altere o cache
+      bool consulta(const string &chave, vector<int> &ordem) const;
+      void guarda(const string &chave, const vector<int> &ordem);
+
+      unsigned long get_acertos();
+      unsigned long get_falhas();
+};
+
+#endif // _CACHERECURSAO_H
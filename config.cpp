@@ -17,6 +17,7 @@ void TConfig::leInfo(xmlDocPtr doc, xmlNode * a_node)
    xmlNode *cur_node = NULL;
    xmlChar *key;
    int val;
+   string texto;
 
    for (cur_node = a_node; cur_node; cur_node = cur_node->next)
    {
@@ -24,6 +25,7 @@ void TConfig::leInfo(xmlDocPtr doc, xmlNode * a_node)
       {
          key = xmlNodeListGetString(doc, cur_node->xmlChildrenNode, 1);
          val = atoi((char *)key);
+         texto = (key != NULL)?(char *)key:"";
          xmlFree(key);
 
          if (!xmlStrcmp(cur_node->name, (xmlChar *)"tamanhoPopulacao")) tamPopulacao = val;
@@ -40,6 +42,22 @@ void TConfig::leInfo(xmlDocPtr doc, xmlNode * a_node)
          else if (!xmlStrcmp(cur_node->name, (xmlChar *)"selecao")) selecao = val;
          else if (!xmlStrcmp(cur_node->name, (xmlChar *)"selIndMutacao")) selIndMutacao = val;
 		   else if (!xmlStrcmp(cur_node->name, (xmlChar *)"profundidadeMaxima")) profundidadeMaxima = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"armazenamentoMapa")) armazenamentoMapa = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"cacheBinario")) cacheBinario = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"qtdeVizinhos")) qtdeVizinhos = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"tamCacheRecursao")) tamCacheRecursao = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"numThreads")) numThreads = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"numIlhas")) numIlhas = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"intervaloMigracao")) intervaloMigracao = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"taxaMigracao")) taxaMigracao = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"topologiaMigracao")) topologiaMigracao = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"transporteMigracao")) transporteMigracao = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"idIlha")) idIlha = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"enderecoMigracao")) enderecoMigracao = texto;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"registroBinario")) registroBinario = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"nivelLog")) nivelLog = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"amostragemLog")) amostragemLog = val;
+         else if (!xmlStrcmp(cur_node->name, (xmlChar *)"intervaloLog")) intervaloLog = val;
 
       }
 
@@ -64,6 +82,22 @@ TConfig::TConfig()
    percentElitismo = 70;
    profundidadeMaxima = 5;
 	selecao = 0;
+   armazenamentoMapa = 2;
+   cacheBinario = 1;
+   qtdeVizinhos = 10;
+   tamCacheRecursao = 1024;
+   numThreads = 0;
+   numIlhas = 1;
+   intervaloMigracao = 10;
+   taxaMigracao = 5;
+   topologiaMigracao = 0;
+   transporteMigracao = 0;
+   idIlha = 0;
+   enderecoMigracao = "/tspilhas";
+   registroBinario = 0;
+   nivelLog = 3;
+   amostragemLog = 0;
+   intervaloLog = 10;
 }
 
 void TConfig::carregaDoArquivo(char *nomeArquivo)
@@ -14,9 +14,13 @@
 #define	_CONFIG_H
 
 
+#include <stdlib.h>
+#include <string>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 
+using namespace std;
+
 /*********************************************************
 Classe de configuração, utilizada para acelerar o processo
 de testes, estava ruim compilar para cada configuração e
@@ -49,6 +53,39 @@ class TConfig
                                    //  0 - o melhor individuo nunca é selecionado
                                    //  1 - o melhor individuo sempre é seleconado
                                    //  2 - seleção do melhor individuo é aleatória
+      int armazenamentoMapa;       //Forma de armazenamento da matriz de distâncias
+                                   //  0 - matriz completa
+                                   //  1 - triangular (apenas instâncias simétricas)
+                                   //  2 - automático, triangular se a instância for simétrica
+                                   //  3 - apenas coordenadas, distância calculada na hora
+      int cacheBinario;            //Gera / usa o arquivo binário <instância>.bin
+                                   //  0 - sempre lê a instância original
+                                   //  1 - usa o binário se estiver atualizado
+      int qtdeVizinhos;            //Tamanho da lista de vizinhos mais próximos de cada gene (NJ e MIO)
+      int tamCacheRecursao;        //Qtde de subproblemas da recursão guardados (0 desliga)
+      int numThreads;              //Threads na geração dos descendentes e nas mutações
+                                   //  0 - geração sequencial
+                                   //  n - n threads, mesmo resultado para qualquer n > 0
+      int numIlhas;                //Quantidade de ilhas (populações), uma thread por ilha
+      int intervaloMigracao;       //Gerações entre migrações
+      int taxaMigracao;            //% da população que migra
+      int topologiaMigracao;       //0 - anel, 1 - completa, 2 - aleatória
+      int transporteMigracao;      //0 - threads, 1 - memória compartilhada, 2 - socket
+      int idIlha;                  //Ilha deste processo (transportes 1 e 2)
+      string enderecoMigracao;     //Nome da memória compartilhada ou endereço do socket
+      int registroBinario;         //Gerações no arquivo binário <saída>.trc (tspconv converte)
+                                   //  0 - no arquivo texto, como linhas ;Profundidade;...
+                                   //  1 - registros binários de tamanho fixo
+      int nivelLog;                //Linhas de geração no log (cada nível inclui os anteriores)
+                                   //  0 - só o resumo da execução
+                                   //  1 - gerações da profundidade 0
+                                   //  2 - melhorias obtidas na recursão
+                                   //  3 - gerações de todas as profundidades
+      int amostragemLog;           //Quais gerações, entre as do nível, vão para o log
+                                   //  0 - todas
+                                   //  1 - a cada intervaloLog gerações
+                                   //  2 - só quando o melhor melhora
+      int intervaloLog;            //Intervalo da amostragem 1
 
       /*******************************************************
            Os valores padrões são os utilizados no artigo
@@ -620,9 +620,9 @@ vector <TIndividuo *>TCruzamento::DPX(TIndividuo *parceiro1, TIndividuo *parceir
 		{
 			g1 = fragmentoFim[0];
 			g2 = fragmentoIni[i];
-			double custo1 = VP_Mapa->get_distancia(g1->ori, g2->dest);
+			double custo1 = VP_Mapa->get_dist(g1->ori, g2->dest);
 			g2 = fragmentoFim[i];
-			double custo2 = VP_Mapa->get_distancia(g1->ori, g2->dest);
+			double custo2 = VP_Mapa->get_dist(g1->ori, g2->dest);
 
          if(custo1 <= custo2)
 			{
@@ -901,7 +901,7 @@ vector <TIndividuo *>TCruzamento::HX(TIndividuo *parceiro1, TIndividuo *parceiro
       gTmp = filho1->get_por_id(found->prox->id);	
 		if ((gTmp->i > ini && gTmp->i < fim) || (gTmp->i==0 && fim == filho1->get_qtdeGenes()))
 		{
-		   custo = VP_Mapa->get_distancia(found->ori, found->prox->dest);
+		   custo = VP_Mapa->get_dist(found->ori, found->prox->dest);
 			if (custo < min)
 			{
 				min = custo;
@@ -913,7 +913,7 @@ vector <TIndividuo *>TCruzamento::HX(TIndividuo *parceiro1, TIndividuo *parceiro
       gTmp = filho1->get_por_id(found->ant->id);
 		if ((gTmp->i > ini && gTmp->i < fim) || (gTmp->i==0 && fim == filho1->get_qtdeGenes()))
 		{
-		   custo = VP_Mapa->get_distancia(found->ori, found->ant->dest);
+		   custo = VP_Mapa->get_dist(found->ori, found->ant->dest);
 			if (custo < min)
 			{
 				min = custo;
@@ -928,7 +928,7 @@ vector <TIndividuo *>TCruzamento::HX(TIndividuo *parceiro1, TIndividuo *parceiro
       gTmp = filho1->get_por_id(found->prox->id);
 		if ((gTmp->i > ini && gTmp->i < fim) || (gTmp->i==0 && fim == filho1->get_qtdeGenes()))
 		{
-		   custo = VP_Mapa->get_distancia(found->ori, found->prox->dest);
+		   custo = VP_Mapa->get_dist(found->ori, found->prox->dest);
 			if (custo < min)
 			{
 				min = custo;
@@ -940,7 +940,7 @@ vector <TIndividuo *>TCruzamento::HX(TIndividuo *parceiro1, TIndividuo *parceiro
       gTmp = filho1->get_por_id(found->ant->id);	
 		if ((gTmp->i > ini && gTmp->i < fim) || (gTmp->i==0 && fim == filho1->get_qtdeGenes()))
 		{
-		   custo = VP_Mapa->get_distancia(found->ori, found->ant->dest);     		
+		   custo = VP_Mapa->get_dist(found->ori, found->ant->dest);     		
 			if (custo < min)
 			{
 				min = custo;
@@ -1063,27 +1063,39 @@ vector <TIndividuo *>TCruzamento::MIO (TIndividuo *parceiro1, TPopulacao *popula
 	unsigned qtdeMelhores = 5;
 	TGene *c = filho1->get_por_indice(i);
 	TGene *c_prim;
+	bool usaVizinhos = (filho1->is_genesCidades())
+	                   &&((unsigned) VP_Mapa->get_qtdeVizinhos() >= min(qtdeMelhores, (unsigned) filho1->get_qtdeGenes()-2));
 	
 	while (true)
 	{
 		if(TUtils::flip(Prd))
 		{
-			vector<pair <int, double> > custos;
-			for (int ii=1; ii<filho1->get_qtdeGenes(); ii++)
+			if (usaVizinhos)
 			{
-				if (ii==c->i) continue;
-				c_prim = filho1->get_por_indice(ii);
-				VP_Mapa->get_distancia(c->ori, c_prim->dest);
-				pair <int, double> custo (ii, VP_Mapa->get_distancia(c->ori, c_prim->dest));
-				custos.push_back(custo);					
-			}		
-			sort (custos.begin(), custos.end(), compare_pair_second<std::less>());
+				//Os genes são as cidades: a lista de vizinhos do mapa já está ordenada
+				j = TUtils::rnd(0, min(qtdeMelhores, (unsigned) VP_Mapa->get_qtdeVizinhos())-1);
+				c_prim = filho1->get_por_id(VP_Mapa->get_vizinhos(c->id)[j]);
+				j = c_prim->i;
+			}
+			else
+			{
+				vector<pair <int, double> > custos;
+				for (int ii=1; ii<filho1->get_qtdeGenes(); ii++)
+				{
+					if (ii==c->i) continue;
+					c_prim = filho1->get_por_indice(ii);
+					VP_Mapa->get_dist(c->ori, c_prim->dest);
+					pair <int, double> custo (ii, VP_Mapa->get_dist(c->ori, c_prim->dest));
+					custos.push_back(custo);					
+				}		
+				sort (custos.begin(), custos.end(), compare_pair_second<std::less>());
 							 
-			j = TUtils::rnd(0, (custos.size()>qtdeMelhores)?qtdeMelhores-1:custos.size()-1);
-			j = custos[j].first;
-			c_prim = filho1->get_por_indice(j);
+				j = TUtils::rnd(0, (custos.size()>qtdeMelhores)?qtdeMelhores-1:custos.size()-1);
+				j = custos[j].first;
+				c_prim = filho1->get_por_indice(j);
 			
-			custos.clear();
+				custos.clear();
+			}
 		}
 		else
 		{
@@ -1236,7 +1248,7 @@ vector <TIndividuo *>TCruzamento::ER (TIndividuo *parceiro1, TIndividuo *parceir
 		g = filho1->get_por_indice(i);
 		
 		//Servirá como a parte aleatória a medida que as posições	
-		custoMelhor = VP_Mapa->get_distancia(g->ori, g->prox->dest);
+		custoMelhor = VP_Mapa->get_dist(g->ori, g->prox->dest);
       idMelhor = g->prox->id;
       
 		//########################
@@ -1251,7 +1263,7 @@ vector <TIndividuo *>TCruzamento::ER (TIndividuo *parceiro1, TIndividuo *parceir
 		if (gVizinho->i > i) //ainda não faz parte do filho
 		{
 			//Verifico o custo
-			custoTemp = VP_Mapa->get_distancia(g->ori, gVizinho->dest);
+			custoTemp = VP_Mapa->get_dist(g->ori, gVizinho->dest);
 			//Se tiver melhor custo, é um candidato a substituição
 			if(custoTemp < custoMelhor)
 			{
@@ -1266,7 +1278,7 @@ vector <TIndividuo *>TCruzamento::ER (TIndividuo *parceiro1, TIndividuo *parceir
 		if (gVizinho->i > i) //ainda não faz parte do filho
 		{
 			//Verifico o custo
-			custoTemp = VP_Mapa->get_distancia(g->ori, gVizinho->dest);
+			custoTemp = VP_Mapa->get_dist(g->ori, gVizinho->dest);
 			//Se tiver melhor custo, é um candidato a substituição
 			if(custoTemp < custoMelhor)
 			{
@@ -1287,7 +1299,7 @@ vector <TIndividuo *>TCruzamento::ER (TIndividuo *parceiro1, TIndividuo *parceir
 		if (gVizinho->i > i) //ainda não faz parte do filho
 		{
 			//Verifico o custo
-			custoTemp = VP_Mapa->get_distancia(g->ori, gVizinho->dest);
+			custoTemp = VP_Mapa->get_dist(g->ori, gVizinho->dest);
 			//Se tiver melhor custo, é um candidato a substituição
 			if(custoTemp < custoMelhor)
 			{
@@ -1302,7 +1314,7 @@ vector <TIndividuo *>TCruzamento::ER (TIndividuo *parceiro1, TIndividuo *parceir
 		if (gVizinho->i > i) //ainda não faz parte do filho
 		{
 			//Verifico o custo
-			custoTemp = VP_Mapa->get_distancia(g->ori, gVizinho->dest);
+			custoTemp = VP_Mapa->get_dist(g->ori, gVizinho->dest);
 			//Se tiver melhor custo, é um candidato a substituição
 			if(custoTemp < custoMelhor)
 			{
@@ -0,0 +1,44 @@
+/*
+*  gerador.cpp
+*
+*  Módulo responsável pelo gerador de números aleatórios (xoshiro256**).
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 17/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#include "gerador.hpp"
+
+static uint64_t splitmix64(uint64_t &x)
+{
+   uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+
+   z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+   z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+   return z ^ (z >> 31);
+}
+
+TGerador::TGerador(uint64_t semente, uint64_t fluxo)
+{
+   semeia(semente, fluxo);
+}
+
+void TGerador::semeia(uint64_t semente, uint64_t fluxo)
+{
+   //O fluxo passa pelo splitmix antes de ser combinado com a semente, para
+   //que fluxos vizinhos não comecem de estados vizinhos
+   uint64_t f = fluxo;
+   uint64_t x = semente ^ splitmix64(f);
+
+   for (int i=0; i<4; i++)
+      VP_estado[i] = splitmix64(x);
+}
+
+void TGerador::preenche(uint32_t *destino, int qtde, uint32_t n)
+{
+   for (int i=0; i<qtde; i++)
+      destino[i] = limitado(n);
+}
@@ -0,0 +1,80 @@
+/*
+*  gerador.hpp
+*
+*  Módulo responsável pelo gerador de números aleatórios (xoshiro256**).
+*  Cada gerador é um fluxo independente, identificado pela semente e pelo
+*  número do fluxo, para que cada thread (slot, tarefa, ilha, execução)
+*  tenha o seu sem depender da ordem em que as threads rodam
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 17/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#ifndef _GERADOR_H
+#define	_GERADOR_H
+
+#include <stdint.h>
+
+using namespace std;
+
+class TGerador
+{
+   private:
+      uint64_t VP_estado[4];
+
+      static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+   public:
+      //O estado é iniciado pelo splitmix64, a partir da semente e do fluxo
+      TGerador(uint64_t semente = 0, uint64_t fluxo = 0);
+      void semeia(uint64_t semente, uint64_t fluxo);
+
+      //Os sorteios ficam no cabeçalho para poderem ser expandidos (inline)
+      uint64_t proximo()
+      {
+         const uint64_t resultado = rotl(VP_estado[1] * 5, 7) * 9;
+         const uint64_t t = VP_estado[1] << 17;
+
+         VP_estado[2] ^= VP_estado[0];
+         VP_estado[3] ^= VP_estado[1];
+         VP_estado[1] ^= VP_estado[2];
+         VP_estado[0] ^= VP_estado[3];
+         VP_estado[2] ^= t;
+         VP_estado[3] = rotl(VP_estado[3], 45);
+
+         return resultado;
+      }
+
+      //Inteiro em [0, n) sem viés (Lemire), quase sempre sem divisão.
+      //n = 0 representa 2^32
+      uint32_t limitado(uint32_t n)
+      {
+         if (n == 0) return (uint32_t)(proximo() >> 32);
+
+         uint64_t m = (proximo() >> 32) * (uint64_t)n;
+         uint32_t l = (uint32_t)m;
+
+         if (l < n)
+         {
+            uint32_t limite = -n % n;
+            while (l < limite)
+            {
+               m = (proximo() >> 32) * (uint64_t)n;
+               l = (uint32_t)m;
+            }
+         }
+         return (uint32_t)(m >> 32);
+      }
+
+      //Real em [0, 1), com os 53 bits da mantissa
+      double real() { return (proximo() >> 11) * (1.0 / 9007199254740992.0); }
+
+      //Sorteios em lote: qtde inteiros em [0, n), sem passar pelo gerador
+      //da thread (TUtils) a cada número
+      void preenche(uint32_t *destino, int qtde, uint32_t n);
+};
+
+#endif
@@ -0,0 +1,150 @@
+/*
+*  ilhas.cpp
+*
+*  Módulo responsável pelo modelo de ilhas. Cada ilha é um AG completo,
+*  executado em sua própria thread (ou processo), e a cada intervalo de
+*  gerações as ilhas trocam os seus melhores indivíduos (migração)
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 16/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#include "ilhas.hpp"
+#include "utils.hpp"
+#include <iostream>
+
+TIlhas::TIlhas (vector <TAlgGenetico *> ags, int primeira, int qtdeIlhas, TTransporte *transporte,
+                TArqLog *arqSaida, int intervalo, int taxa, int topologia)
+{
+   VP_ags        = ags;
+   VP_primeira   = primeira;
+   VP_qtdeIlhas  = qtdeIlhas;
+   VP_transporte = transporte;
+   VP_ArqSaida   = arqSaida;
+   VP_intervalo  = (intervalo > 0)?intervalo:1;
+   VP_taxa       = taxa;
+   VP_topologia  = topologia;
+
+   for (unsigned i=0; i<VP_ags.size(); i++)
+      VP_ags[i]->setIlha(this, VP_primeira + i);
+}
+
+TIlhas::~TIlhas ()
+{
+   for (unsigned i=0; i<VP_ags.size(); i++)
+      delete VP_ags[i];
+
+   delete VP_transporte;
+}
+
+void TIlhas::exec ()
+{
+   int qtde = VP_ags.size();
+   int melhor = 0;
+   uint64_t semente = TUtils::sorteia();
+
+   #pragma omp parallel for schedule(static, 1) num_threads(qtde)
+   for (int i=0; i<qtde; i++)
+   {
+      //Fluxo pelo id da ilha: com a mesma semente, ilhas em processos
+      //diferentes também têm fluxos diferentes
+      TGerador gerador(semente, VP_primeira + i);
+
+      TUtils::set_gerador(&gerador);
+      VP_ags[i]->exec();
+      TUtils::set_gerador(NULL);
+   }
+
+   for (int i=0; i<qtde; i++)
+   {
+      string lin = "Ilha;";
+      lin += to_string(VP_primeira + i);
+      lin += "; Melhor Alcançado;";
+      lin += to_string(VP_ags[i]->get_melhor_dst());
+      lin += "; Geração;";
+      lin += to_string(VP_ags[i]->get_melhor_gera());
+      VP_ArqSaida->addLinha(lin);
+
+      if (VP_ags[i]->get_melhor_dst() < VP_ags[melhor]->get_melhor_dst()) melhor = i;
+   }
+
+   string lin = "Melhor Ilha;";
+   lin += to_string(VP_primeira + melhor);
+   lin += "; melhor;";
+   lin += to_string(VP_ags[melhor]->get_melhor_dst());
+   VP_ArqSaida->addLinha(lin);
+   if (VP_ags[0]->getPrintParcial()) cout << lin << endl;
+}
+
+void TIlhas::envia (int ilha, int destino, TPopulacao *populacao, int qtde)
+{
+   TIndividuo *individuo;
+
+   //Destino atrasado, com a fila cheia: o migrante é descartado
+   for (int i=0; i<qtde; i++)
+   {
+      individuo = populacao->get_individuo(i);
+      VP_transporte->envia(ilha, destino, individuo->get_rota(), individuo->get_distancia());
+   }
+}
+
+void TIlhas::migra (int ilha, TPopulacao *populacao, int geracao)
+{
+   TIndividuo *individuo;
+   unsigned substituidos = 0;
+   vector <int> ids(populacao->get_individuo(0)->get_qtdeGenes());
+   double custo;
+
+   //A população chega ordenada (iteracao): os melhores saem e os
+   //imigrantes entram no lugar dos piores, nunca no do melhor
+   if (geracao % VP_intervalo == 0)
+   {
+      int qtde = populacao->get_qtdeIndividuo() * VP_taxa / 100;
+      if (qtde < 1) qtde = 1;
+
+      switch (VP_topologia)
+      {
+         case topologiaCompleta:
+         {
+            for (int d=0; d<VP_qtdeIlhas; d++)
+               if (d != ilha) envia(ilha, d, populacao, qtde);
+            break;
+         }
+         case topologiaAleatoria:
+         {
+            int d = TUtils::rnd(0, VP_qtdeIlhas-2);
+            if (d >= ilha) d++;
+            envia(ilha, d, populacao, qtde);
+            break;
+         }
+         default:  //anel
+         {
+            envia(ilha, (ilha+1) % VP_qtdeIlhas, populacao, qtde);
+            break;
+         }
+      }
+   }
+
+   //O migrante reaproveita o indivíduo que ele substitui. Migrantes
+   //piores que o indivíduo a ser substituído são descartados. O custo que
+   //vem com o migrante não é confiável (outro processo / outra máquina):
+   //vale o recalculado no mapa local
+   while (VP_transporte->recebe(ilha, ids.data(), custo))
+   {
+      if (substituidos+1 >= populacao->get_qtdeIndividuo()) continue;
+
+      individuo = populacao->get_individuo(populacao->get_qtdeIndividuo()-1-substituidos);
+      custo = individuo->custoRota(ids.data());
+      if (custo >= individuo->get_distancia()) continue;
+
+      populacao->sub_dist_tot(individuo->get_distancia());
+      individuo->set_rota(ids.data());
+      populacao->soma_dist_tot(individuo->get_distancia());
+      substituidos++;
+   }
+
+   if (substituidos > 0) populacao->ordena();
+}
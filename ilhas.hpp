@@ -0,0 +1,61 @@
+/*
+*  ilhas.hpp
+*
+*  Módulo responsável pelo modelo de ilhas. Cada ilha é um AG completo,
+*  executado em sua própria thread (ou processo), e a cada intervalo de
+*  gerações as ilhas trocam os seus melhores indivíduos (migração)
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 16/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#ifndef _ILHAS_H
+#define	_ILHAS_H
+
+#include <vector>
+#include "ag.hpp"
+#include "transporte.hpp"
+#include "populacao.hpp"
+#include "individuo.hpp"
+#include "arqlog.hpp"
+
+using namespace std;
+
+class TIlhas
+{
+   public:
+      static const int topologiaAnel      = 0;
+      static const int topologiaCompleta  = 1;
+      static const int topologiaAleatoria = 2;
+
+   private:
+      //Ilhas deste processo, com ids VP_primeira, VP_primeira+1, ...
+      vector <TAlgGenetico *> VP_ags;
+      int VP_primeira;
+      int VP_qtdeIlhas;
+      TTransporte *VP_transporte;
+
+      int VP_intervalo;
+      int VP_taxa;
+      int VP_topologia;
+
+      TArqLog *VP_ArqSaida;
+
+      void envia (int ilha, int destino, TPopulacao *populacao, int qtde);
+
+   public:
+      //As ilhas (AGs) já configuradas e o transporte passam a pertencer a
+      //esta classe. qtdeIlhas é o total, somando as de outros processos
+      TIlhas (vector <TAlgGenetico *> ags, int primeira, int qtdeIlhas, TTransporte *transporte,
+              TArqLog *arqSaida, int intervalo, int taxa, int topologia);
+      ~TIlhas ();
+
+      void exec ();
+      //Chamado pela ilha ao final de cada geração
+      void migra (int ilha, TPopulacao *populacao, int geracao);
+};
+
+#endif
@@ -12,6 +12,7 @@
 
 #include "individuo.hpp"
 #include <iostream>
+#include <string.h>
 
 //Apenas letura
 TMapaGenes *TIndividuo::getMapa() { return VP_Mapa; }
@@ -23,19 +24,21 @@ void TIndividuo::set_extra (int val) { VP_Extra = val; }
 double TIndividuo::get_distancia()    { return VP_dist; }
 double TIndividuo::get_distanciaInv() { return VP_distInv; }
 
-TGene *TIndividuo::get_ini () { return VP_indice[0]; }
-TGene *TIndividuo::get_por_indice (int indice) { return VP_indice[indice]; }
-TGene *TIndividuo::get_por_id (int id) { return VP_direto[id]; }
+TGene *TIndividuo::get_ini () { return VP_genes + VP_rota[0]; }
+TGene *TIndividuo::get_por_indice (int indice) { return VP_genes + VP_rota[indice]; }
+TGene *TIndividuo::get_por_id (int id) { return VP_genes + id; }
 
 int TIndividuo::ind_prox(int ind) { return (ind<(VP_qtdeGenes-1))?ind+1:0; }
 TGene *TIndividuo::prox (TGene *gene) { return gene->prox; }
-TGene *TIndividuo::prox (int idG) { return VP_direto[idG]->prox; }
+TGene *TIndividuo::prox (int idG) { return VP_genes[idG].prox; }
 
 int TIndividuo::ind_ant(int ind) { return (ind>0)?ind-1:(VP_qtdeGenes-1); }
 TGene *TIndividuo::ant (TGene *gene) { return gene->ant; }
-TGene *TIndividuo::ant (int idG) { return VP_direto[idG]->ant; }
+TGene *TIndividuo::ant (int idG) { return VP_genes[idG].ant; }
 
 int TIndividuo::get_qtdeGenes() { return VP_qtdeGenes; }
+bool TIndividuo::is_genesCidades() { return VP_genesCidades; }
+bool TIndividuo::is_reversoSimetrico() { return VP_reversoSimetrico; }
 
 //Métodos
 TIndividuo::TIndividuo (TMapaGenes *mapa, TArqLog *arqSaida)
@@ -46,17 +49,163 @@ TIndividuo::TIndividuo (TMapaGenes *mapa, TArqLog *arqSaida)
    VP_Extra = 0;
    VP_dist = 0;
 	VP_distInv = 0;
+   VP_qtdeGenes = 0;
    VP_qtdeGeneAlloc = 0;
+   VP_genes = NULL;
+   VP_rota = NULL;
+   VP_genesCidades = false;
+   VP_reversoSimetrico = false;
+   VP_custoIda = NULL;
+   VP_custoVolta = NULL;
+   VP_arestaIda = NULL;
+   VP_arestaVolta = NULL;
+   VP_custosValidos = false;
+   VP_qtdeCorrecoes = 0;
+   VP_somasCorrecoes = 0;
+}
+
+TIndividuo::TIndividuo (const TIndividuo &outro)
+{
+   VP_qtdeGenes = 0;
+   VP_qtdeGeneAlloc = 0;
+   VP_genes = NULL;
+   VP_rota = NULL;
+   VP_custoIda = NULL;
+   VP_custoVolta = NULL;
+   VP_arestaIda = NULL;
+   VP_arestaVolta = NULL;
+   VP_custosValidos = false;
+   VP_qtdeCorrecoes = 0;
+   VP_somasCorrecoes = 0;
+   *this = outro;
+}
+
+//Genes e rota são copiados de uma vez (um só bloco). Depois os
+//ponteiros, que apontam para o bloco do outro indivíduo, são refeitos
+TIndividuo &TIndividuo::operator= (const TIndividuo &outro)
+{
+   if (this == &outro) return *this;
+
+   VP_Mapa = outro.VP_Mapa;
+   VP_ArqSaida = outro.VP_ArqSaida;
+   VP_Extra = outro.VP_Extra;
+   VP_dist = outro.VP_dist;
+   VP_distInv = outro.VP_distInv;
+   VP_genesCidades = outro.VP_genesCidades;
+   VP_reversoSimetrico = outro.VP_reversoSimetrico;
+
+   aloca(outro.VP_qtdeGenes);
+   VP_qtdeGenes = outro.VP_qtdeGenes;
+   if (VP_qtdeGenes == 0) return *this;
+
+   memcpy(VP_genes, outro.VP_genes, (long)VP_qtdeGenes*(sizeof(TGene)+sizeof(int)));
+   encadeia(0, VP_qtdeGenes-1);
+
+   return *this;
 }
 
 TIndividuo::~TIndividuo()
 {
-   for (vector< TGene *>::iterator i=VP_indice.begin(); i!=VP_indice.end(); ++i)
+   free (VP_genes);
+   free (VP_custoIda);
+   VP_genes = NULL;
+   VP_rota = NULL;
+}
+
+void TIndividuo::aloca (int qtde)
+{
+   if (qtde > VP_qtdeGeneAlloc)
    {
-     delete (*i);
+      free (VP_genes);
+      free (VP_custoIda);
+      VP_genes = (TGene *) malloc((long)qtde*(sizeof(TGene)+sizeof(int)));
+      VP_custoIda = NULL;
+      VP_custoVolta = NULL;
+      VP_arestaIda = NULL;
+      VP_arestaVolta = NULL;
+      VP_qtdeGeneAlloc = qtde;
+   }
+   //Rota nova (ou de outro indivíduo)
+   VP_custosValidos = false;
+   //A rota fica logo após os genes
+   VP_rota = (int *) (VP_genes + qtde);
+}
+
+void TIndividuo::encadeia (int ini, int fim)
+{
+   TGene *g;
+   TGene *anterior = VP_genes + VP_rota[ind_ant(ini)];
+
+   for (int p=ini; p<=fim; p++)
+   {
+      g = VP_genes + VP_rota[p];
+      g->i = p;
+      g->ant = anterior;
+      anterior->prox = g;
+      anterior = g;
+   }
+
+   //Fechando com o gene seguinte ao trecho
+   g = VP_genes + VP_rota[ind_prox(fim)];
+   anterior->prox = g;
+   g->ant = anterior;
+
+   if (VP_custosValidos) corrigeCustos(ini, fim);
+}
+
+//Mudaram as arestas das posições ini-1 a fim. Cada uma fica com a
+//diferença para a aresta da mesma posição no último calcCustos
+void TIndividuo::corrigeCustos (int ini, int fim)
+{
+   int p;
+   int k;
+   TGene *g;
+   TGene *proxG;
+   double ida;
+   double volta;
+
+   if (fim-ini+2 > limiteCorrecoes)
+   {
+      VP_custosValidos = false;
+      return;
+   }
+
+   for (int q=ini-1; q<=fim; q++)
+   {
+      p = (q < 0) ? VP_qtdeGenes-1 : q;
+      g = VP_genes + VP_rota[p];
+      proxG = VP_genes + VP_rota[ind_prox(p)];
+      ida = VP_Mapa->get_dist(g->ori, proxG->dest) - VP_arestaIda[p];
+      volta = VP_Mapa->get_dist(proxG->ori, g->dest) - VP_arestaVolta[p];
+
+      for (k=0; (k<VP_qtdeCorrecoes)&&(VP_posCorrecao[k]!=p); k++);
+
+      //Voltou a ser a aresta original (ex.: movimento desfeito)
+      if ((ida == 0.0)&&(volta == 0.0))
+      {
+         if (k < VP_qtdeCorrecoes)
+         {
+            VP_qtdeCorrecoes--;
+            VP_posCorrecao[k] = VP_posCorrecao[VP_qtdeCorrecoes];
+            VP_corrIda[k] = VP_corrIda[VP_qtdeCorrecoes];
+            VP_corrVolta[k] = VP_corrVolta[VP_qtdeCorrecoes];
+         }
+         continue;
+      }
+
+      if (k == VP_qtdeCorrecoes)
+      {
+         if (k == limiteCorrecoes)
+         {
+            VP_custosValidos = false;
+            return;
+         }
+         VP_qtdeCorrecoes++;
+         VP_posCorrecao[k] = p;
+      }
+      VP_corrIda[k] = ida;
+      VP_corrVolta[k] = volta;
    }
-   VP_indice.clear();
-   VP_direto.clear();
 }
 
 //Cria um novo indivíduo
@@ -65,29 +214,27 @@ void TIndividuo::novo ()
    TGene *gene;
    VP_qtdeGenes = VP_Mapa->get_qtdeGenes();
    VP_dist = 0;
+   VP_genesCidades = true;
+   VP_reversoSimetrico = VP_Mapa->is_simetrico();
+   aloca(VP_qtdeGenes);
 
    for (int i=0; i<VP_qtdeGenes; i++)
    {
-      gene = new TGene;
+      gene = VP_genes + i;
       gene->id   = i;
       gene->ori  = i;
       gene->dest = i;
-      gene->i    = i;
-      VP_direto.push_back (gene);
-      VP_indice.push_back (gene);
-      if (i==0) continue;
-      VP_direto[i]->ant = VP_direto[i-1];
-      VP_direto[i-1]->prox = VP_direto[i];
-      VP_dist += VP_Mapa->get_distancia(VP_direto[i-1]->ori, VP_direto[i]->dest);
+      VP_rota[i] = i;
    }
-   //Fechando o ciclo
-   VP_direto[VP_qtdeGenes-1]->prox = VP_direto[0];
-   VP_direto[0]->ant = VP_direto[VP_qtdeGenes-1];
+   encadeia(0, VP_qtdeGenes-1);
+
+   for (int i=1; i<VP_qtdeGenes; i++)
+      VP_dist += VP_Mapa->get_dist(VP_genes[i-1].ori, VP_genes[i].dest);
 
    //Se o indivíduo foi modificado, o 2opt deve começar do início
    VP_Extra = 0;
 
-   VP_dist += VP_Mapa->get_distancia(VP_direto[VP_qtdeGenes-1]->ori, VP_direto[0]->dest);
+   VP_dist += VP_Mapa->get_dist(VP_genes[VP_qtdeGenes-1].ori, VP_genes[0].dest);
 	VP_distInv = 1/VP_dist;
 }
 
@@ -96,33 +243,29 @@ void TIndividuo::novo (vector<TTipoConversao> genes, int extraPadrao)
    TGene *gene;
    VP_qtdeGenes = genes.size();
    VP_dist = 0;
+   VP_genesCidades = (VP_qtdeGenes == VP_Mapa->get_qtdeGenes());
+   VP_reversoSimetrico = VP_Mapa->is_simetrico();
+   aloca(VP_qtdeGenes);
 
    for (int i=0; i<VP_qtdeGenes; i++)
    {
-      gene = new TGene;
+      gene = VP_genes + i;
       gene->id   = i;
       gene->ori  = genes[i].ulOrig;
       gene->dest = genes[i].prDest;
-      gene->i    = i;
-
-      VP_direto.push_back (gene);
-      VP_indice.push_back (gene);
-
-      if (i==0) continue;
-      VP_indice[i]->ant = VP_indice[i-1];
-      VP_indice[i-1]->prox = VP_indice[i];
-
-      VP_dist += VP_Mapa->get_distancia(VP_indice[i-1]->ori, VP_indice[i]->dest);
+      VP_rota[i] = i;
+      if ((gene->ori != i)||(gene->dest != i)) VP_genesCidades = false;
+      if (gene->ori != gene->dest) VP_reversoSimetrico = false;
    }
+   encadeia(0, VP_qtdeGenes-1);
 
-   //Fechando o ciclo
-   VP_indice[VP_qtdeGenes-1]->prox = VP_indice[0];
-   VP_indice[0]->ant = VP_indice[VP_qtdeGenes-1];
+   for (int i=1; i<VP_qtdeGenes; i++)
+      VP_dist += VP_Mapa->get_dist(VP_genes[i-1].ori, VP_genes[i].dest);
 
    //Se o indivíduo foi modificado, o 2opt deve começar do início
    VP_Extra = extraPadrao;
 
-   VP_dist += VP_Mapa->get_distancia(VP_indice[VP_qtdeGenes-1]->ori, VP_indice[0]->dest);	
+   VP_dist += VP_Mapa->get_dist(VP_genes[VP_qtdeGenes-1].ori, VP_genes[0].dest);
 	VP_distInv = 1/VP_dist;
 }
 
@@ -131,43 +274,38 @@ void TIndividuo::novo (vector<TGene *> genes)
 {
    TGene *gene;
    VP_qtdeGenes = genes.size();
-   VP_direto.resize (VP_qtdeGenes);
    VP_dist = 0;
+   VP_genesCidades = (VP_qtdeGenes == VP_Mapa->get_qtdeGenes());
+   VP_reversoSimetrico = VP_Mapa->is_simetrico();
+   aloca(VP_qtdeGenes);
 
    for (int i=0; i<VP_qtdeGenes; i++)
    {
-      gene = new TGene;
+      gene = VP_genes + genes[i]->id;
       gene->id   = genes[i]->id;
       gene->ori  = genes[i]->ori;
       gene->dest = genes[i]->dest;
-      gene->i    = i;
-
-      VP_direto[gene->id] = gene;
-      VP_indice.push_back (gene);
-
-      if (i==0) continue;
-      VP_indice[i]->ant = VP_indice[i-1];
-      VP_indice[i-1]->prox = VP_indice[i];
-
-      VP_dist += VP_Mapa->get_distancia(VP_indice[i-1]->ori, VP_indice[i]->dest);
+      VP_rota[i] = gene->id;
+      if ((gene->ori != gene->id)||(gene->dest != gene->id)) VP_genesCidades = false;
+      if (gene->ori != gene->dest) VP_reversoSimetrico = false;
    }
+   encadeia(0, VP_qtdeGenes-1);
 
-   //Fechando o ciclo
-   VP_indice[VP_qtdeGenes-1]->prox = VP_indice[0];
-   VP_indice[0]->ant = VP_indice[VP_qtdeGenes-1];
+   for (int i=1; i<VP_qtdeGenes; i++)
+      VP_dist += VP_Mapa->get_dist(get_por_indice(i-1)->ori, get_por_indice(i)->dest);
 
    //Se o indivíduo foi modificado, o 2opt deve começar do início
    VP_Extra = 0;
 
-   VP_dist += VP_Mapa->get_distancia(VP_indice[VP_qtdeGenes-1]->ori, VP_indice[0]->dest);
+   VP_dist += VP_Mapa->get_dist(get_por_indice(VP_qtdeGenes-1)->ori, get_por_indice(0)->dest);
 }
 
 string TIndividuo::toString ()
 {
    string resultado = "";
-   for (vector< TGene *>::iterator i=VP_indice.begin(); i!=VP_indice.end(); ++i)
+   for (int i=0; i<VP_qtdeGenes; i++)
    {
-     resultado += to_string( (*i)->id);
+     resultado += to_string( get_por_indice(i)->id);
      resultado += ";";
    }
    return resultado;
@@ -176,20 +314,20 @@ string TIndividuo::toString ()
 string TIndividuo::toStringExpand ()
 {
    string resultado = "";
-   for (vector< TGene *>::iterator i=VP_indice.begin(); i!=VP_indice.end(); ++i)
+   for (int i=0; i<VP_qtdeGenes; i++)
    {
-     resultado += to_string( (*i)->id);
+     resultado += to_string( get_por_indice(i)->id);
 	 resultado += "[";
-     resultado += to_string( (*i)->ori );
+     resultado += to_string( get_por_indice(i)->ori );
      resultado += ",";
-     resultado += to_string( (*i)->dest );
+     resultado += to_string( get_por_indice(i)->dest );
      resultado += "] ";
      resultado += "(";
-     resultado += to_string( (*i)->ant->id );
+     resultado += to_string( get_por_indice(i)->ant->id );
      resultado += ",";
-     resultado += to_string( (*i)->prox->id );
+     resultado += to_string( get_por_indice(i)->prox->id );
      resultado += " / ";
-     resultado += to_string( (*i)->i);
+     resultado += to_string( get_por_indice(i)->i);
      resultado += ")";
      resultado += ";";
    }
@@ -199,9 +337,9 @@ string TIndividuo::toStringExpand ()
 string TIndividuo::toString (int init)
 {
    string resultado = "";
-   for (vector< TGene *>::iterator i=VP_indice.begin(); i!=VP_indice.end(); ++i)
+   for (int i=0; i<VP_qtdeGenes; i++)
    {
-     resultado += to_string( (*i)->id+1);
+     resultado += to_string( get_por_indice(i)->id+1);
      resultado += ";";
    }
    return resultado;
@@ -209,14 +347,14 @@ string TIndividuo::toString (int init)
 
 void TIndividuo::troca(int g1, int g2)
 {
-   troca_indice(VP_direto[g1]->i, VP_direto[g2]->i);
+   troca_indice(VP_genes[g1].i, VP_genes[g2].i);
 }
 
 void TIndividuo::troca_indice(int index1, int index2)
 {
    if ((index1==0)||(index2==0)||(index1==index2)) return;
 
-   TGene *tempG;
+   int tempG;
 
    if(index1>index2)
    {
@@ -225,42 +363,32 @@ void TIndividuo::troca_indice(int index1, int index2)
       index2 = i;
    }
 
-   VP_dist -= VP_Mapa->get_distancia(VP_indice[ind_ant(index1)]->ori, VP_indice[index1]->dest);
-   VP_dist -= VP_Mapa->get_distancia(VP_indice[index2]->ori, VP_indice[ind_prox(index2)]->dest);
-   VP_dist -= VP_Mapa->get_distancia(VP_indice[index1]->ori, VP_indice[ind_prox(index1)]->dest);
+   VP_dist -= VP_Mapa->get_dist(get_por_indice(ind_ant(index1))->ori, get_por_indice(index1)->dest);
+   VP_dist -= VP_Mapa->get_dist(get_por_indice(index2)->ori, get_por_indice(ind_prox(index2))->dest);
+   VP_dist -= VP_Mapa->get_dist(get_por_indice(index1)->ori, get_por_indice(ind_prox(index1))->dest);
 
    //se = distância de 1 a 1+1 = distância de 2-1 a 2
    //Seria contado duas vezes
    if((ind_prox(index1))!=index2)
-      VP_dist -= VP_Mapa->get_distancia(VP_indice[ind_ant(index2)]->ori, VP_indice[index2]->dest);
-
-   tempG = VP_indice[index1];
-   VP_indice[index1] = VP_indice[index2];
-   VP_indice[index2] = tempG;
-   VP_indice[index1]->i = index1;
-   VP_indice[index2]->i = index2;
-
-   //resolvendo o encadeamento para index1
-   VP_indice[ind_ant(index1)]->prox = VP_indice[index1];
-   VP_indice[index1]->ant = VP_indice[ind_ant(index1)];
-   VP_indice[index1]->prox = VP_indice[ind_prox(index1)];
-   VP_indice[ind_prox(index1)]->ant = VP_indice[index1];
-
-   //resolvendo o encadeamento para index2
-   VP_indice[ind_ant(index2)]->prox = VP_indice[index2];
-   VP_indice[index2]->ant = VP_indice[ind_ant(index2)];
-   VP_indice[index2]->prox = VP_indice[ind_prox(index2)];
-   VP_indice[ind_prox(index2)]->ant = VP_indice[index2];
+      VP_dist -= VP_Mapa->get_dist(get_por_indice(ind_ant(index2))->ori, get_por_indice(index2)->dest);
+
+   tempG = VP_rota[index1];
+   VP_rota[index1] = VP_rota[index2];
+   VP_rota[index2] = tempG;
+
+   //resolvendo o encadeamento para index1 e index2
+   encadeia(index1, index1);
+   encadeia(index2, index2);
 
    //Somando as novas dstâncias
-   VP_dist += VP_Mapa->get_distancia(VP_indice[ind_ant(index1)]->ori, VP_indice[index1]->dest);
-   VP_dist += VP_Mapa->get_distancia(VP_indice[index2]->ori, VP_indice[ind_prox(index2)]->dest);
-   VP_dist += VP_Mapa->get_distancia(VP_indice[index1]->ori, VP_indice[ind_prox(index1)]->dest);
+   VP_dist += VP_Mapa->get_dist(get_por_indice(ind_ant(index1))->ori, get_por_indice(index1)->dest);
+   VP_dist += VP_Mapa->get_dist(get_por_indice(index2)->ori, get_por_indice(ind_prox(index2))->dest);
+   VP_dist += VP_Mapa->get_dist(get_por_indice(index1)->ori, get_por_indice(ind_prox(index1))->dest);
 
    //se = distância de 1 a 1+1 = distância de 2-1 a 2
    //Seria contado duas vezes
    if((ind_prox(index1))!=index2)
-      VP_dist += VP_Mapa->get_distancia(VP_indice[ind_ant(index2)]->ori, VP_indice[index2]->dest);
+      VP_dist += VP_Mapa->get_dist(get_por_indice(ind_ant(index2))->ori, get_por_indice(index2)->dest);
 		
    VP_distInv = 1/VP_dist;
 }
@@ -274,7 +402,9 @@ void TIndividuo::troca_indice(int index1, int index2)
 */
 void TIndividuo::troca_sub(int index1, int size1, int index2, int size2)
 {
-   int ini1, ini2, increment1, increment2;
+   bool inverte1, inverte2;
+   int fim;
+   double novaDist;
 
    //Por convenção, a rota sempre iniciará no gene 0
    //logo, este não pode ser trocado
@@ -285,54 +415,72 @@ void TIndividuo::troca_sub(int index1, int size1, int index2, int size2)
    //if ((size1==size2)&&(size1==0)) return;
    if (size1==0 && size2==0) return;
 
-   if (size1>0) 
-   { 
-      ini1 = index1;
-      increment1 = 1;
-   }
-   else //Inverte o bloco
+   //Tamanho negativo: inverte o bloco
+   inverte1 = (size1<0);
+   if (inverte1) size1 *= -1;
+   inverte2 = (size2<0);
+   if (inverte2) size2 *= -1;
+   
+   //Não pode sobrepor
+   if (index1+size1>index2) return;
+   //Não pode ultrapassar
+   if (index2+size2>this->get_qtdeGenes()) return;
+
+   fim = index2+size2-1;
+
+   //Trechos na ordem atual (bloco 1, meio, bloco 2) e na nova (bloco 2, meio, bloco 1).
+   //Vazios são ignorados
+   TGene *ini[3], *ult[3];
+   bool inv[3];
+   int qtde = 0;
+   int tam[3] = {size2, index2-index1-size1, size1};
+   int pos[3] = {index2, index1+size1, index1};
+   bool invNovo[3] = {inverte2, false, inverte1};
+
+   novaDist = VP_dist;
+
+   //Arestas atuais que serão desfeitas
+   TGene *g = get_por_indice(index1-1);
+   for (int k=2; k>=0; k--)
    {
-      size1 *= -1;
-      ini1 = index1+size1-1;
-      increment1 = -1;
+      if (tam[k]==0) continue;
+      novaDist -= VP_Mapa->get_dist(g->ori, get_por_indice(pos[k])->dest);
+      g = get_por_indice(pos[k]+tam[k]-1);
    }
+   novaDist -= VP_Mapa->get_dist(g->ori, get_por_indice(ind_prox(fim))->dest);
 
-   if (size2>0) 
-   { 
-      ini2 = index2;
-      increment2 = 1;
+   //Trechos na nova ordem, com as pontas já trocadas se forem invertidos
+   for (int k=0; k<3; k++)
+   {
+      if (tam[k]==0) continue;
+      inv[qtde] = invNovo[k];
+      ini[qtde] = get_por_indice(inv[qtde] ? pos[k]+tam[k]-1 : pos[k]);
+      ult[qtde] = get_por_indice(inv[qtde] ? pos[k] : pos[k]+tam[k]-1);
+      //Custo interno do bloco invertido
+      if (inv[qtde]) novaDist += get_dif_reverso(ult[qtde], ini[qtde]);
+      qtde++;
    }
-   else //Inverte inverte o bloco
+
+   //Arestas novas
+   g = get_por_indice(index1-1);
+   for (int k=0; k<qtde; k++)
    {
-      size2 *= -1;
-      ini2 = index2+size2-1;
-      increment2 = -1;
+      novaDist += VP_Mapa->get_dist(g->ori, ini[k]->dest);
+      g = ult[k];
    }
-   
-   //Não pode sobrepor
-   if (index1+size1>index2) return;
-   //Não pode ultrapassar
-   if (index2+size2>this->get_qtdeGenes()) return;
- 
-   //Montando os bolocos
-   int v1[size1];
-   int v2[size2];
-   int vm[index2-index1-size1];
-  
-   //Montando o prmeiro bloco
-   for (int i = 0, j=ini1; i<size1; i++, j+=increment1) v1[i] = this->VP_indice[j]->id; 
-   //Montando a parte entre os 2 blocos
-   for(int i = 0, j=index1+size1; i<index2-index1-size1; i++, j++) vm[i] = this->VP_indice[j]->id;
-   //Montando o segundo bloco
-   for (int i = 0, j=ini2; i<size2; i++, j+=increment2) v2[i] = this->VP_indice[j]->id;
-
-   //Remontando o indivíduo
-   //o segundo bloco passa a ser o prmeiro
-   for (int i = 0, j=index1; i<size2; i++, j++) this->troca (this->VP_indice[j]->id, v2[i]); 
-   //O bloco do meio
-   for(int i = 0, j=index1+size2; i<index2-index1-size1; i++, j++) this->troca (this->VP_indice[j]->id,vm[i]);
-   //o prmeiro bloco passará a ser o segundo
-   for (int i = 0, j=index2+size2-size1; i<size1; i++, j++) this->troca (this->VP_indice[j]->id, v1[i]); 	
+   novaDist += VP_Mapa->get_dist(g->ori, get_por_indice(ind_prox(fim))->dest);
+
+   //Invertendo toda a região, ficam bloco 2, meio e bloco 1, cada um invertido.
+   //Depois, desfaz a inversão dos que devem manter a ordem
+   reverse(VP_rota + index1, VP_rota + fim + 1);
+   if (!inverte2) reverse(VP_rota + index1, VP_rota + index1 + size2);
+   reverse(VP_rota + index1 + size2, VP_rota + fim + 1 - size1);
+   if (!inverte1) reverse(VP_rota + fim + 1 - size1, VP_rota + fim + 1);
+
+   encadeia(index1, fim);
+
+   VP_dist = novaDist;
+   VP_distInv = 1/VP_dist;
 }
 
 void TIndividuo::embaralha ()
@@ -343,7 +491,6 @@ void TIndividuo::embaralha ()
 void TIndividuo::embaralha (int index1, int index2)
 {
    int rd1;
-   int rd2;
 
    if (index1>index2)
    {
@@ -352,12 +499,13 @@ void TIndividuo::embaralha (int index1, int index2)
       index2 = rd1;
    }
 
-   for (int i=0; i<=((index2-index1)/2); i++)
-   {
-      rd1 = TUtils::rnd(index1, index2);
-      rd2 = TUtils::rnd(index1, index2);
-      troca_indice(rd1, rd2);
-   }
+   //Os pares de posições são sorteados de uma vez
+   int qtde = (index2-index1)/2 + 1;
+   vector <int> sorteios(2*qtde);
+
+   TUtils::rnd(sorteios.data(), 2*qtde, index1, index2);
+   for (int i=0; i<qtde; i++)
+      troca_indice(sorteios[2*i], sorteios[2*i+1]);
 }
 
 void TIndividuo::recalcDist ()
@@ -365,11 +513,101 @@ void TIndividuo::recalcDist ()
 	VP_dist = 0;
 
 	for (int i = 0; i<VP_qtdeGenes; i++)
-      VP_dist += VP_Mapa->get_distancia(VP_indice[ind_ant(i)]->ori, VP_indice[i]->dest);
+      VP_dist += VP_Mapa->get_dist(get_por_indice(ind_ant(i))->ori, get_por_indice(i)->dest);
 	
 	VP_distInv = 1/VP_dist;
 }
 
+const int *TIndividuo::get_rota () { return VP_rota; }
+
+void TIndividuo::set_rota (const int *ids)
+{
+   memcpy(VP_rota, ids, VP_qtdeGenes*sizeof(int));
+   encadeia(0, VP_qtdeGenes-1);
+   recalcDist();
+}
+
+double TIndividuo::custoRota (const int *ids)
+{
+   double custo = 0.0;
+
+   for (int p=0; p<VP_qtdeGenes; p++)
+      custo += VP_Mapa->get_dist(VP_genes[ids[p]].ori, VP_genes[ids[(p+1) % VP_qtdeGenes]].dest);
+   return custo;
+}
+
+void TIndividuo::calcCustos ()
+{
+   TGene *g;
+   TGene *proxG;
+
+   //Os quatro vetores num só bloco
+   if (VP_custoIda == NULL)
+   {
+      VP_custoIda = (double *) malloc(4L*(VP_qtdeGeneAlloc+1)*sizeof(double));
+      VP_custoVolta = VP_custoIda + (VP_qtdeGeneAlloc+1);
+      VP_arestaIda = VP_custoVolta + (VP_qtdeGeneAlloc+1);
+      VP_arestaVolta = VP_arestaIda + (VP_qtdeGeneAlloc+1);
+   }
+
+   VP_custoIda[0] = 0.0;
+   VP_custoVolta[0] = 0.0;
+   for (int p=0; p<VP_qtdeGenes; p++)
+   {
+      g = VP_genes + VP_rota[p];
+      proxG = g->prox;
+      VP_arestaIda[p] = VP_Mapa->get_dist(g->ori, proxG->dest);
+      VP_arestaVolta[p] = VP_Mapa->get_dist(proxG->ori, g->dest);
+      VP_custoIda[p+1] = VP_custoIda[p] + VP_arestaIda[p];
+      VP_custoVolta[p+1] = VP_custoVolta[p] + VP_arestaVolta[p];
+   }
+
+   VP_qtdeCorrecoes = 0;
+   VP_somasCorrecoes = 0;
+   VP_custosValidos = true;
+}
+
+//Custo acumulado até a posição, com as correções das arestas anteriores
+double TIndividuo::somaIda (int pos)
+{
+   double soma = VP_custoIda[pos];
+
+   for (int k=0; k<VP_qtdeCorrecoes; k++)
+      if (VP_posCorrecao[k] < pos) soma += VP_corrIda[k];
+   return soma;
+}
+
+double TIndividuo::somaVolta (int pos)
+{
+   double soma = VP_custoVolta[pos];
+
+   for (int k=0; k<VP_qtdeCorrecoes; k++)
+      if (VP_posCorrecao[k] < pos) soma += VP_corrVolta[k];
+   return soma;
+}
+
+double TIndividuo::get_dif_reverso(TGene *G1, TGene *G2)
+{
+   int i = G1->i;
+   int j = G2->i;
+
+   if ((i == j)||(VP_reversoSimetrico)) return 0.0;
+
+   if (!VP_custosValidos) calcCustos();
+   else if (VP_qtdeCorrecoes > 0)
+   {
+      VP_somasCorrecoes += VP_qtdeCorrecoes;
+      if (VP_somasCorrecoes > VP_qtdeGenes) calcCustos();
+   }
+
+   //O trecho passa pelo fim da rota e volta ao início
+   if (i > j)
+      return (somaVolta(VP_qtdeGenes) - somaVolta(i) + somaVolta(j))
+           - (somaIda(VP_qtdeGenes) - somaIda(i) + somaIda(j));
+
+   return (somaVolta(j) - somaVolta(i)) - (somaIda(j) - somaIda(i));
+}
+
 double TIndividuo::get_dist_sub_reverso(TGene *G1, TGene *G2)
 {
    TGene *tempG;
@@ -384,36 +622,46 @@ double TIndividuo::get_dist_sub_reverso(TGene *G1, TGene *G2)
 
    double tot=VP_dist;
 
+   //Mapa simétrico: as arestas internas mantêm o custo, só mudam as pontas
+   if (VP_reversoSimetrico)
+      return tot - VP_Mapa->get_dist(G1->ant->ori, G1->dest) - VP_Mapa->get_dist(G2->ori, G2->prox->dest)
+                 + VP_Mapa->get_dist(G1->ant->ori, G2->dest) + VP_Mapa->get_dist(G1->ori, G2->prox->dest);
+
    //Entre os genes 1 e 2, a soma é do caminho de retorno ou seja, de 2 para 1
-   for (tempG=G1; tempG->id!=G2->id; tempG = tempG->prox)
-   {
-      tot -= VP_Mapa->get_distancia(tempG->ori, tempG->prox->dest);
-      tot += VP_Mapa->get_distancia(tempG->prox->ori, tempG->dest);
-   }
+   tot += get_dif_reverso(G1, G2);
 
    //Arestas que ficaram faltando
-   tot -= VP_Mapa->get_distancia(G1->ant->ori, G1->dest);
-   tot -= VP_Mapa->get_distancia(G2->ori, G2->prox->dest);
+   tot -= VP_Mapa->get_dist(G1->ant->ori, G1->dest);
+   tot -= VP_Mapa->get_dist(G2->ori, G2->prox->dest);
 
-   tot += VP_Mapa->get_distancia(G1->ant->ori, G2->dest);
-   tot += VP_Mapa->get_distancia(G1->ori, G2->prox->dest);
+   tot += VP_Mapa->get_dist(G1->ant->ori, G2->dest);
+   tot += VP_Mapa->get_dist(G1->ori, G2->prox->dest);
 
    return tot;
 }
 
 double TIndividuo::get_dist_sub_reverso_id(int id1, int id2)
 {
-   return get_dist_sub_reverso (VP_direto[id1], VP_direto[id2]);
+   return get_dist_sub_reverso (VP_genes + id1, VP_genes + id2);
 }
 
 double TIndividuo::get_dist_sub_reverso_indice(int indice1, int indice2)
 {
-   return get_dist_sub_reverso (VP_indice[indice1], VP_indice[indice2]);
+   return get_dist_sub_reverso (get_por_indice(indice1), get_por_indice(indice2));
 }
 
+//Inverte o trecho de uma vez: a nova distância vem do delta das pontas
+//(e, se for o caso, dos custos acumulados) e só o trecho é reencadeado.
+//Custo O(indice2-indice1), mesmo para trechos longos.
+//Obs.: o lado complementar não é invertido no lugar do trecho. Ele contém
+//o gene 0, que precisa voltar à posição 0: depois de invertê-lo, a rota
+//teria que ser rotacionada, o que custa O(n) sempre. Além disso, só daria
+//o mesmo ciclo em mapas simétricos (no assimétrico o sentido muda o custo)
 void TIndividuo::inverte_sub_indice (int indice1, int indice2)
 {
    int i;
+   double novaDist;
+
    if ((indice1==0)||(indice2==0)||(indice1==indice2)) return;
    else if (indice1>indice2)
    {
@@ -422,8 +670,13 @@ void TIndividuo::inverte_sub_indice (int indice1, int indice2)
       indice2 = i;
    }
 
-   for (i=0; i<=(indice2-indice1)/2;i++)
-      troca_indice(indice1+i, indice2-i);
+   novaDist = get_dist_sub_reverso(get_por_indice(indice1), get_por_indice(indice2));
+
+   reverse(VP_rota + indice1, VP_rota + indice2 + 1);
+   encadeia(indice1, indice2);
+
+   VP_dist = novaDist;
+   VP_distInv = 1/VP_dist;
 }
 
 void TIndividuo::inverte_sub (TGene *G1, TGene *G2)
@@ -433,58 +686,152 @@ void TIndividuo::inverte_sub (TGene *G1, TGene *G2)
 
 void TIndividuo::inverte_sub_id (int id1, int id2)
 {
-   inverte_sub_indice (VP_direto[id1]->i, VP_direto[id2]->i);
+   inverte_sub_indice (VP_genes[id1].i, VP_genes[id2].i);
 }
 
 //Clona o individuo. Necessário para o elitismo
 TIndividuo *TIndividuo::clona ()
 {
-   TIndividuo *clone = new TIndividuo(getMapa(), getArqLog());
-   clone->novo(VP_indice);
-   clone->set_extra(get_extra());
-   return clone;
+   return new TIndividuo(*this);
 }
 
-int TIndividuo::melhorPossivel()
+//Tabelas do melhorPossivel, uma por thread, pois as tarefas da recursão
+//podem resolver indivíduos ao mesmo tempo. Só crescem e são reaproveitadas
+//entre as chamadas. Liberadas no fim da thread
+struct TTabelasExatas
 {
-   int melhorou = 0; //retrna false (=0) quando não mehora ou true (!=0) quando melhora 
-   vector<TGene *> melhor;
-   vector<TGene *> temp;
-   double melhorDist = get_distancia();
-   double distTemp;
+   double *custos;
+   double *tabela;
+   unsigned char *pai;
+   long capacidade;   //posições de tabela / pai
+   int capCustos;     //posições de custos
+
+   TTabelasExatas () : custos(NULL), tabela(NULL), pai(NULL), capacidade(0), capCustos(0) {}
+   ~TTabelasExatas ()
+   {
+      free (custos);
+      free (tabela);
+      free (pai);
+   }
+
+   bool reserva (int qtdeCustos, long qtde)
+   {
+      if (qtdeCustos > capCustos)
+      {
+         free (custos);
+         custos = (double *) malloc(qtdeCustos*sizeof(double));
+         capCustos = (custos != NULL)?qtdeCustos:0;
+      }
+      if (qtde > capacidade)
+      {
+         free (tabela);
+         free (pai);
+         tabela = (double *) malloc(qtde*sizeof(double));
+         pai = (unsigned char *) malloc(qtde);
+         capacidade = ((tabela != NULL)&&(pai != NULL))?qtde:0;
+      }
+      return (capCustos >= qtdeCustos)&&(capacidade >= qtde);
+   }
+};
 
-   //Realizando todas as combinações, fixando o 0, pois é um ciclo
-   for(int i=1;i<get_qtdeGenes();++i) temp.push_back(get_por_id(i));
+static thread_local TTabelasExatas tabelasExatas;
 
-   do
+int TIndividuo::melhorPossivel()
+{
+   int m = VP_qtdeGenes-1;   //genes livres, o 0 fica fixo
+   long qtdeMascaras;
+   long mascara;
+   long completa;
+   long anterior;
+   int j, k, ultimo;
+   double custo, melhorDist;
+   double *custos;
+   double *tabela;
+   unsigned char *pai;
+   TGene *livres[limiteMelhorPossivel+1];
+
+   if ((m < 2)||(m > limiteMelhorPossivel)) return 0;
+
+   //tabela[mascara*m + j]: menor caminho saindo do 0, passando pelos genes
+   //da máscara e terminando em j. As linhas de uma máscara ficam juntas
+   qtdeMascaras = 1L << m;
+   completa = qtdeMascaras - 1;
+   if (!tabelasExatas.reserva((m+1)*(m+1), qtdeMascaras*m)) return 0;
+   custos = tabelasExatas.custos;
+   tabela = tabelasExatas.tabela;
+   pai = tabelasExatas.pai;
+
+   //Custos entre os genes, numa matriz local pequena. Posição 0 é o gene 0
+   for (j=0; j<=m; j++) livres[j] = VP_genes + j;
+
+   for (j=0; j<=m; j++)
+      for (k=0; k<=m; k++)
+         custos[j*(m+1)+k] = VP_Mapa->get_dist(livres[j]->ori, livres[k]->dest);
+
+   for (mascara=1; mascara<qtdeMascaras; mascara++)
    {
-      //Calculando o peso total de cada permutação
-      distTemp = VP_Mapa->get_distancia(VP_direto[0]->ori, temp[0]->dest);
-      for (unsigned i=1;i<temp.size();++i) distTemp += VP_Mapa->get_distancia(temp[i-1]->ori, temp[i]->dest);
-      distTemp += VP_Mapa->get_distancia(temp[temp.size()-1]->ori ,VP_direto[0]->dest);
+      double *linha = tabela + mascara*m;
+      unsigned char *linhaPai = pai + mascara*m;
 
-      if (distTemp<melhorDist)
+      for (j=0; j<m; j++)
       {
-         melhorDist = distTemp;
-         melhor = temp;
+         linha[j] = infinito;
+         if (!(mascara & (1L<<j))) continue;
+
+         anterior = mascara ^ (1L<<j);
+         if (anterior == 0)
+         {
+            linha[j] = custos[j+1];
+            linhaPai[j] = m;
+            continue;
+         }
+
+         double *linhaAnt = tabela + anterior*m;
+         for (k=0; k<m; k++)
+         {
+            if (!(anterior & (1L<<k))) continue;
+            custo = linhaAnt[k] + custos[(k+1)*(m+1) + j+1];
+            if (custo < linha[j])
+            {
+               linha[j] = custo;
+               linhaPai[j] = k;
+            }
+         }
       }
-   }while(next_permutation(temp.begin(),temp.end()));
+   }
 
-   //Se encontrei combinação melhor do que a existente
-   if (melhorDist<get_distancia())
+   //Fechando o ciclo de volta ao 0
+   melhorDist = infinito;
+   ultimo = -1;
+   for (j=0; j<m; j++)
    {
-      melhorou = 1;
-      //Mudo o individuo para mesma sequência do melhor
-      for (int i=1;i<get_qtdeGenes()-1;++i)
+      custo = tabela[completa*m + j] + custos[(j+1)*(m+1)];
+      if (custo < melhorDist)
       {
-         if (VP_indice[i]->id!=melhor[i-1]->id)
-            troca_indice(i, (get_por_id(melhor[i-1]->id))->i);
+         melhorDist = custo;
+         ultimo = j;
       }
    }
-   
-   melhor.clear();
-   temp.clear();
-   
+
+   //Se encontrei combinação melhor do que a existente,
+   //a rota é remontada do fim para o início
+   int melhorou = ((ultimo >= 0)&&(melhorDist < get_distancia()))?1:0;
+   if (melhorou)
+   {
+      VP_rota[0] = livres[0]->id;
+      mascara = completa;
+      for (int p=m; p>=1; p--)
+      {
+         VP_rota[p] = livres[ultimo+1]->id;
+         k = pai[mascara*m + ultimo];
+         mascara ^= 1L<<ultimo;
+         ultimo = k;
+      }
+      encadeia(0, VP_qtdeGenes-1);
+
+      VP_dist = melhorDist;
+      VP_distInv = 1/VP_dist;
+   }
+
    return melhorou;
 }
-
@@ -26,17 +26,66 @@ class indivíduo. Uma sequência de genes encadeados
 
 class TIndividuo
 {
+   public:
+      //Maior quantidade de genes livres (sem o 0) resolvida de forma
+      //exata pelo melhorPossivel. As tabelas ocupam 2^n * n * 9 bytes por
+      //thread: 42 MB com 18, 189 MB com 20 e 830 MB com 22. Com as tarefas
+      //recursivas (numThreads) resolvendo ao mesmo tempo, 20 a 25 genes não
+      //cabem na memória, e o tempo (n² 2^n) passa do esforço de um AG
+      static const int limiteMelhorPossivel = 18;
+
    private:
       int VP_Extra;
 
-      vector <TGene *> VP_direto;
-      vector <TGene *> VP_indice;
+      //Genes em um único bloco, indexado pelo id, seguido da rota
+      //(id do gene em cada posição). gene->i é a posição de cada gene.
+      //prox / ant apontam para dentro do bloco e são refeitos pela rota
+      TGene *VP_genes;
+      int *VP_rota;
 
       int VP_qtdeGenes;
       double VP_dist;
 		double VP_distInv; // 1/VP_dist para roleta
 
-      int VP_qtdeGeneAlloc;
+      int VP_qtdeGeneAlloc;   //capacidade do bloco de genes
+
+      //Verdadeiro se cada gene é uma cidade do mapa (id == ori == dest),
+      //ou seja, não é um indivíduo reduzido da recursão
+      bool VP_genesCidades;
+
+      //Verdadeiro se o mapa é simétrico e todo gene tem ori == dest.
+      //Assim, inverter um trecho só altera as duas arestas das pontas
+      bool VP_reversoSimetrico;
+
+      //Custos acumulados pela rota, de 0 até cada posição (a posição N
+      //inclui a aresta que fecha o ciclo). VP_custoVolta soma as mesmas
+      //arestas percorridas ao contrário. VP_arestaIda / VP_arestaVolta são
+      //as arestas de cada posição quando os custos foram calculados
+      double *VP_custoIda;
+      double *VP_custoVolta;
+      double *VP_arestaIda;
+      double *VP_arestaVolta;
+      bool VP_custosValidos;
+      void calcCustos ();
+
+      //Arestas alteradas depois do calcCustos, pela posição. Enquanto forem
+      //poucas, as consultas somam as correções e o encadeia não invalida os
+      //custos. Acima do limite, são refeitos na próxima consulta. Também são
+      //refeitos quando as somas das consultas já custaram um calcCustos
+      static const int limiteCorrecoes = 16;
+      int VP_qtdeCorrecoes;
+      long VP_somasCorrecoes;
+      int VP_posCorrecao[limiteCorrecoes];
+      double VP_corrIda[limiteCorrecoes];
+      double VP_corrVolta[limiteCorrecoes];
+      void corrigeCustos (int ini, int fim);
+      double somaIda (int pos);
+      double somaVolta (int pos);
+
+      //Garante espaço para a quantidade de genes
+      void aloca (int qtde);
+      //Refaz prox / ant / i dos genes das posições ini a fim
+      void encadeia (int ini, int fim);
 
       TMapaGenes *VP_Mapa;
       TArqLog *VP_ArqSaida;
@@ -53,6 +102,8 @@ class TIndividuo
 
       //Métodos
       TIndividuo (TMapaGenes *mapa, TArqLog *arqSaida);
+      TIndividuo (const TIndividuo &outro);
+      TIndividuo &operator= (const TIndividuo &outro);
 
       ~TIndividuo();
 
@@ -69,6 +120,8 @@ class TIndividuo
       TGene *ant (int idG);
 
       int get_qtdeGenes();
+      bool is_genesCidades();
+      bool is_reversoSimetrico();
 
       double get_distancia ();
 		double get_distanciaInv ();
@@ -102,12 +155,23 @@ class TIndividuo
       //Recalcula o valor de um indivduo
       void recalcDist ();
 
+      //Ids dos genes na ordem da rota (leitura) / substitui a rota inteira,
+      //usados na migração entre ilhas
+      const int *get_rota ();
+      void set_rota (const int *ids);
+      //Custo da rota dada pelos ids, sem alterar o indivíduo
+      double custoRota (const int *ids);
+
+      //Diferença de custo das arestas internas de G1 até G2 (seguindo prox)
+      //se o trecho for invertido. O(1) com os custos acumulados
+      double get_dif_reverso(TGene *G1, TGene *G2);
+
       //Calcula a distância total no caso de uma sub-rota ser invertida
       double get_dist_sub_reverso(TGene *G1, TGene *G2);
       double get_dist_sub_reverso_id(int id1, int id2);
       double get_dist_sub_reverso_indice(int indice1, int indice2);
 
-      //Inverte o caminho de uma sub-rota
+      //Inverte o caminho de uma sub-rota, em O(tamanho do trecho)
       void inverte_sub_indice (int indice1, int indice2);
       void inverte_sub (TGene *G1, TGene *G2);
       void inverte_sub_id (int id1, int id2);
@@ -116,6 +180,9 @@ class TIndividuo
 
       //Clona o individuo. Necessário para o elitismo
       TIndividuo *clona ();
+
+      //Melhor rota possível, exata, por programação dinâmica (Held-Karp),
+      //fixando o gene 0. Custo O(n² 2^n), n = genes livres
       int melhorPossivel ();
 };
 
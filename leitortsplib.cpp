@@ -0,0 +1,296 @@
+/*
+*  leitortsplib.cpp
+*
+*  Módulo responsável pela leitura de instâncias no formato texto do TSPLIB (.tsp)
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 16/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#include "leitortsplib.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+TLeitorTSPLIB::TLeitorTSPLIB ()
+{
+   VP_buffer = NULL;
+   VP_pos = NULL;
+   VP_fim = NULL;
+   VP_dimensao = 0;
+   VP_tipoPeso = tipoExplicito;
+   VP_formato = formatoFullMatrix;
+}
+
+TLeitorTSPLIB::~TLeitorTSPLIB ()
+{
+   free (VP_buffer);
+}
+
+bool TLeitorTSPLIB::isTSPLIB (const char *nomeArquivo)
+{
+   int tam = strlen(nomeArquivo);
+
+   if ((tam>=4)&&(!strcasecmp(nomeArquivo+tam-4, ".tsp"))) return true;
+   if ((tam>=5)&&(!strcasecmp(nomeArquivo+tam-5, ".atsp"))) return true;
+   return false;
+}
+
+bool TLeitorTSPLIB::igual (const char *texto, int tam, const char *palavra)
+{
+   return ((int)strlen(palavra)==tam)&&(!strncasecmp(texto, palavra, tam));
+}
+
+/*
+   Lê a próxima linha não vazia da parte de especificação,
+   no formato "CHAVE : VALOR". Chave e valor apontam para
+   dentro do buffer, sem cópia
+*/
+bool TLeitorTSPLIB::proximaLinha (char *&chave, int &tamChave, char *&valor, int &tamValor)
+{
+   char *fimLinha;
+   char *sep;
+
+   while (VP_pos < VP_fim)
+   {
+      fimLinha = (char *) memchr(VP_pos, '\n', VP_fim-VP_pos);
+      if (fimLinha == NULL) fimLinha = VP_fim;
+
+      chave = VP_pos;
+      VP_pos = fimLinha + 1;
+
+      while ((chave<fimLinha)&&((*chave==' ')||(*chave=='\t')||(*chave=='\r'))) chave++;
+      if (chave == fimLinha) continue;
+
+      sep = (char *) memchr(chave, ':', fimLinha-chave);
+      if (sep == NULL)
+      {
+         sep = fimLinha;
+         valor = fimLinha;
+      }
+      else
+         valor = sep + 1;
+
+      //Retirando os espaços do fim da chave
+      while ((sep>chave)&&((sep[-1]==' ')||(sep[-1]=='\t')||(sep[-1]=='\r'))) sep--;
+      tamChave = sep - chave;
+
+      //Retirando os espaços do valor
+      while ((valor<fimLinha)&&((*valor==' ')||(*valor=='\t'))) valor++;
+      sep = fimLinha;
+      while ((sep>valor)&&((sep[-1]==' ')||(sep[-1]=='\t')||(sep[-1]=='\r'))) sep--;
+      tamValor = sep - valor;
+
+      return true;
+   }
+
+   return false;
+}
+
+bool TLeitorTSPLIB::leNumero (double &val)
+{
+   char *fimNum;
+
+   val = strtod(VP_pos, &fimNum);
+   if (fimNum == VP_pos) return false;
+
+   VP_pos = fimNum;
+   return true;
+}
+
+bool TLeitorTSPLIB::leCoordenadas (TMapaGenes *mapa)
+{
+   double id;
+   double x;
+   double y;
+
+   mapa->inicializaCoordenadas(VP_dimensao, VP_tipoPeso);
+   if (mapa->get_qtdeGenes() != VP_dimensao) return false;
+
+   for (int i=0; i<VP_dimensao; i++)
+   {
+      if ((!leNumero(id))||(!leNumero(x))||(!leNumero(y))) return false;
+
+      //No TSPLIB os nós começam em 1
+      if ((id < 1)||(id > VP_dimensao))
+      {
+         printf("Erro: nó %.0f fora da dimensão %d\n", id, VP_dimensao);
+         return false;
+      }
+      mapa->set_coordenada((int)id - 1, x, y);
+   }
+
+   mapa->finalizaCoordenadas();
+   return true;
+}
+
+bool TLeitorTSPLIB::lePesos (TMapaGenes *mapa)
+{
+   int i;
+   int j;
+   int ini;
+   int fim;
+   double val;
+
+   mapa->inicializa(VP_dimensao);
+   if (mapa->get_qtdeGenes() != VP_dimensao) return false;
+
+   for (i=0; i<VP_dimensao; i++)
+   {
+      switch (VP_formato)
+      {
+         case formatoUpperRow:     { ini = i+1; fim = VP_dimensao; break; }
+         case formatoLowerRow:     { ini = 0;   fim = i;           break; }
+         case formatoUpperDiagRow: { ini = i;   fim = VP_dimensao; break; }
+         case formatoLowerDiagRow: { ini = 0;   fim = i+1;         break; }
+         default:                  { ini = 0;   fim = VP_dimensao; break; }
+      }
+
+      for (j=ini; j<fim; j++)
+      {
+         if (!leNumero(val)) return false;
+
+         mapa->set_distancia(i, j, val);
+         //Os formatos triangulares são sempre simétricos
+         if (VP_formato != formatoFullMatrix) mapa->set_distancia(j, i, val);
+      }
+   }
+
+   mapa->defineArmazenamento();
+   return true;
+}
+
+/*
+   Descarta uma seção que não é utilizada.
+   valoresPorLinha > 0: são VP_dimensao linhas com essa quantidade de valores
+   valoresPorLinha = 0: a seção termina com -1
+*/
+void TLeitorTSPLIB::pulaSecao (int valoresPorLinha)
+{
+   double val;
+
+   if (valoresPorLinha > 0)
+   {
+      for (int i=0; i<VP_dimensao*valoresPorLinha; i++)
+         if (!leNumero(val)) return;
+   }
+   else
+   {
+      while (leNumero(val))
+         if (val == -1) return;
+   }
+}
+
+bool TLeitorTSPLIB::carrega (char *nomeArquivo, TMapaGenes *mapa)
+{
+   FILE *arq;
+   long tam;
+   char *chave;
+   char *valor;
+   int tamChave;
+   int tamValor;
+   bool carregado = false;
+
+   arq = fopen(nomeArquivo, "rb");
+   if (arq == NULL)
+   {
+      printf("Erro ao carregar o arquivo %s\n", nomeArquivo);
+      return false;
+   }
+
+   //Lendo todo o arquivo de uma vez
+   fseek(arq, 0, SEEK_END);
+   tam = ftell(arq);
+   fseek(arq, 0, SEEK_SET);
+
+   free (VP_buffer);
+   VP_buffer = (char *) malloc(tam+1);
+   if ((VP_buffer==NULL)||((long)fread(VP_buffer, 1, tam, arq)!=tam))
+   {
+      printf("Erro ao carregar o arquivo %s\n", nomeArquivo);
+      fclose(arq);
+      return false;
+   }
+   fclose(arq);
+
+   VP_buffer[tam] = '\0';
+   VP_pos = VP_buffer;
+   VP_fim = VP_buffer + tam;
+
+   while (proximaLinha(chave, tamChave, valor, tamValor))
+   {
+      if (igual(chave, tamChave, "DIMENSION"))
+         VP_dimensao = atoi(valor);
+      else if (igual(chave, tamChave, "EDGE_WEIGHT_TYPE"))
+      {
+         if      (igual(valor, tamValor, "EXPLICIT")) VP_tipoPeso = tipoExplicito;
+         else if (igual(valor, tamValor, "EUC_2D"))   VP_tipoPeso = TMapaGenes::distEUC_2D;
+         else if (igual(valor, tamValor, "CEIL_2D"))  VP_tipoPeso = TMapaGenes::distCEIL_2D;
+         else if (igual(valor, tamValor, "GEO"))      VP_tipoPeso = TMapaGenes::distGEO;
+         else if (igual(valor, tamValor, "ATT"))      VP_tipoPeso = TMapaGenes::distATT;
+         else
+         {
+            printf("EDGE_WEIGHT_TYPE não suportado: %.*s\n", tamValor, valor);
+            return false;
+         }
+      }
+      else if (igual(chave, tamChave, "EDGE_WEIGHT_FORMAT"))
+      {
+         //Os formatos por coluna são os mesmos por linha, transpostos.
+         //Como são simétricos, a leitura é a mesma
+         if      (igual(valor, tamValor, "FULL_MATRIX"))    VP_formato = formatoFullMatrix;
+         else if (igual(valor, tamValor, "UPPER_ROW"))      VP_formato = formatoUpperRow;
+         else if (igual(valor, tamValor, "LOWER_COL"))      VP_formato = formatoUpperRow;
+         else if (igual(valor, tamValor, "LOWER_ROW"))      VP_formato = formatoLowerRow;
+         else if (igual(valor, tamValor, "UPPER_COL"))      VP_formato = formatoLowerRow;
+         else if (igual(valor, tamValor, "UPPER_DIAG_ROW")) VP_formato = formatoUpperDiagRow;
+         else if (igual(valor, tamValor, "LOWER_DIAG_COL")) VP_formato = formatoUpperDiagRow;
+         else if (igual(valor, tamValor, "LOWER_DIAG_ROW")) VP_formato = formatoLowerDiagRow;
+         else if (igual(valor, tamValor, "UPPER_DIAG_COL")) VP_formato = formatoLowerDiagRow;
+         else if (!igual(valor, tamValor, "FUNCTION"))
+         {
+            printf("EDGE_WEIGHT_FORMAT não suportado: %.*s\n", tamValor, valor);
+            return false;
+         }
+      }
+      else if ((VP_dimensao <= 0)&&((igual(chave, tamChave, "NODE_COORD_SECTION"))||(igual(chave, tamChave, "EDGE_WEIGHT_SECTION"))))
+      {
+         printf("Erro: DIMENSION ausente ou inválida antes de %.*s\n", tamChave, chave);
+         break;
+      }
+      else if (igual(chave, tamChave, "NODE_COORD_SECTION"))
+      {
+         if (VP_tipoPeso == tipoExplicito) pulaSecao(3);
+         else
+         {
+            if (!leCoordenadas(mapa)) break;
+            carregado = true;
+         }
+      }
+      else if (igual(chave, tamChave, "EDGE_WEIGHT_SECTION"))
+      {
+         if (!lePesos(mapa)) break;
+         carregado = true;
+      }
+      else if (igual(chave, tamChave, "DISPLAY_DATA_SECTION"))
+         pulaSecao(3);
+      else if (igual(chave, tamChave, "FIXED_EDGES_SECTION"))
+         pulaSecao(0);
+      else if (igual(chave, tamChave, "EOF"))
+         break;
+   }
+
+   free (VP_buffer);
+   VP_buffer = NULL;
+
+   if (!carregado)
+   {
+      printf("Erro na leitura do arquivo %s\n", nomeArquivo);
+      return false;
+   }
+
+   return true;
+}
@@ -0,0 +1,65 @@
+/*
+*  leitortsplib.hpp
+*
+*  Módulo responsável pela leitura de instâncias no formato texto do TSPLIB (.tsp)
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 16/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#ifndef _LEITORTSPLIB_H
+#define	_LEITORTSPLIB_H
+
+#include "tsp.hpp"
+
+/*********************************************************
+Leitor do formato nativo do TSPLIB. O arquivo é lido de uma
+vez para um único buffer e percorrido por ponteiros, sem
+alocações por token. Lê NODE_COORD_SECTION (EUC_2D, CEIL_2D,
+GEO e ATT) e EDGE_WEIGHT_SECTION em todos os formatos de
+EDGE_WEIGHT_FORMAT
+**********************************************************/
+class TLeitorTSPLIB
+{
+   public:
+      //EDGE_WEIGHT_FORMAT
+      static const int formatoFullMatrix   = 0;
+      static const int formatoUpperRow     = 1;
+      static const int formatoLowerRow     = 2;
+      static const int formatoUpperDiagRow = 3;
+      static const int formatoLowerDiagRow = 4;
+
+      //EDGE_WEIGHT_TYPE explícito (os demais usam os tipos de TMapaGenes)
+      static const int tipoExplicito = -1;
+
+   private:
+      char *VP_buffer;
+      char *VP_pos;
+      char *VP_fim;
+
+      int VP_dimensao;
+      int VP_tipoPeso;
+      int VP_formato;
+
+      //Métodos privados
+      bool proximaLinha (char *&chave, int &tamChave, char *&valor, int &tamValor);
+      bool igual (const char *texto, int tam, const char *palavra);
+      bool leNumero (double &val);
+      bool leCoordenadas (TMapaGenes *mapa);
+      bool lePesos (TMapaGenes *mapa);
+      void pulaSecao (int valoresPorLinha);
+
+   public:
+      TLeitorTSPLIB ();
+      ~TLeitorTSPLIB ();
+
+      //Retorna true se o arquivo for do formato TSPLIB, pela extensão
+      static bool isTSPLIB (const char *nomeArquivo);
+
+      bool carrega (char *nomeArquivo, TMapaGenes *mapa);
+};
+
+#endif
@@ -34,149 +34,359 @@
 #include <string>
 #include "config.hpp"
 #include "ag.hpp"
+#include "ilhas.hpp"
 #include "tsp.hpp"
 
 using namespace std;
 
 #ifdef LIBXML_TREE_ENABLED
 
-int main(int argc, char *argv[])
+TAlgGenetico *criaAG(TConfig *config, TMapaGenes *mapa, TArqLog *arqSaida)
+{
+   TAlgGenetico *ag = new TAlgGenetico(mapa, arqSaida);
+   ag->setMutacao(config->mutacao);
+   ag->setCruzamento(config->cruzamento);
+   ag->setTamPopulacao(config->tamPopulacao);
+   ag->setPrintParcial(config->printParcial);
+   ag->setMaxGeracao(config->maxGeracao);
+   ag->setPercentElitismo(config->percentElitismo);
+   ag->setPercentMutacao(config->percentMutacao);
+   ag->setProfundidadeMaxima(config->profundidadeMaxima);
+   ag->setSelecao(config->selecao);
+   ag->setSelIndMutacao(config->selIndMutacao);
+   ag->setPercentMutacaoRecursiva(config->percentMutacaoRecursiva);
+   ag->setPercentReducao(config->percentReducao);
+   ag->setTamCacheRecursao(config->tamCacheRecursao);
+   ag->setNumThreads(config->numThreads);
+   ag->setRegistroBinario(config->registroBinario);
+   ag->setNivelLog(config->nivelLog);
+   ag->setAmostragemLog(config->amostragemLog);
+   ag->setIntervaloLog(config->intervaloLog);
+   if (config->registroBinario) arqSaida->abreRegistros();
+   return ag;
+}
+
+//Uma execução completa, com o seu arquivo de saída
+void executa(TConfig *config, TMapaGenes *mapa, int countExec, char *arqInstancia, char *arqSaidaBase)
 {
    string nomeArqSaida;
    string cabecalho;
    TAlgGenetico *ag;
-   TMapaGenes *mapa = new TMapaGenes();
-   TConfig *config  = new TConfig();
+   TIlhas *ilhas;
    TArqLog *arqSaida;
 
    time_t tempo;
-   struct tm *tlocal;
+   struct tm tlocal;
    char data[128];
 
+   /* para complemento do nome do arquivo de saida */
+   tempo = time(0);
+   localtime_r(&tempo, &tlocal);
+   strftime(data, 128, "%d_%m_%y_%H_%M_%S", &tlocal);
+   nomeArqSaida = arqSaidaBase;
+   nomeArqSaida += "_";
+   nomeArqSaida += to_string(countExec);
+   nomeArqSaida += "_";
+   nomeArqSaida += data;
+   nomeArqSaida += ".txt";
+
+   if (config->printParcial)
+   {
+      cout << "Execução " << countExec+1 << " / " << config->numExec << " iniciada. "<< endl;
+      cout << "Arquivo de saida de resultados: " << nomeArqSaida << endl;
+   }
+
+   cabecalho   = "Instância;";
+   cabecalho  +=  arqInstancia;
+   cabecalho  +=  "\n";
+
+   cabecalho  += "Execução;";
+   cabecalho  += to_string(countExec+1);
+   cabecalho  += " / ";
+   cabecalho  += to_string(config->numExec);
+   cabecalho  += "\n";
+
+   cabecalho  += "Semente;";
+   cabecalho  += to_string(TUtils::get_semente());
+   cabecalho  += "\n";
+
+   cabecalho  += "Tamanho da Populaçap;";
+   cabecalho  += to_string(config->tamPopulacao);
+   cabecalho  += "\n";
+
+   cabecalho  += "Máximo de gerações;";
+   cabecalho  += to_string(config->maxGeracao);
+   cabecalho  += "\n";
+
+   cabecalho  += "Mutação;";
+   cabecalho  += to_string(config->mutacao);
+   cabecalho  += "\n";
+
+   cabecalho  += "Cruzamento;";
+   cabecalho  += to_string(config->cruzamento);
+   cabecalho  += "\n";
+
+   cabecalho  += "% Manpulação;";
+   cabecalho  += to_string(config->percentManipulacao);
+   cabecalho  += "\n";
+
+   cabecalho  += "% Mutação;";
+   cabecalho  += to_string(config->percentMutacao);
+   cabecalho  += "\n";
+
+   cabecalho  += "Print Parcial;";
+   cabecalho  += to_string(config->printParcial);
+   cabecalho  += "\n";
+
+   cabecalho  += "Ativa Recursivo;";
+   cabecalho  += to_string(config->percentMutacaoRecursiva);
+   cabecalho  += "\n";
+
+   cabecalho  += "Percentual de Redução;";
+   cabecalho  += to_string(config->percentReducao);
+   cabecalho  += "\n";
+
+   cabecalho  += "Profundidade Máxima;";
+   cabecalho  += to_string(config->profundidadeMaxima);
+   cabecalho  += "\n";
+
+   cabecalho  += "Percentual de Eltismo;";
+   cabecalho  += to_string(config->percentElitismo);
+   cabecalho  += "\n";
+
+   cabecalho  += "Seleção para Cruzamento;";
+   cabecalho  += to_string(config->selecao);
+   cabecalho  += "\n";
+
+   cabecalho  += "Forma de Seleção par Mutação;";
+   cabecalho  += to_string(config->selIndMutacao);
+   cabecalho  += "\n";
+
+   cabecalho  += "Armazenamento do Mapa;";
+   cabecalho  += to_string(mapa->get_modo());
+   cabecalho  += (mapa->is_simetrico())?" (simétrico)":" (assimétrico)";
+   cabecalho  += "\n";
+
+   cabecalho  += "Vizinhos mais próximos;";
+   cabecalho  += to_string(mapa->get_qtdeVizinhos());
+   cabecalho  += "\n";
+
+   cabecalho  += "Cache da Recursão;";
+   cabecalho  += to_string(config->tamCacheRecursao);
+   cabecalho  += "\n";
+
+   cabecalho  += "Threads;";
+   cabecalho  += to_string(config->numThreads);
+   cabecalho  += "\n";
+
+   cabecalho  += "Registro Binário;";
+   cabecalho  += to_string(config->registroBinario);
+   cabecalho  += "\n";
+
+   cabecalho  += "Nível de Log;";
+   cabecalho  += to_string(config->nivelLog);
+   cabecalho  += "; Amostragem;";
+   cabecalho  += to_string(config->amostragemLog);
+   if (config->amostragemLog == TAlgGenetico::amostragemIntervalo)
+   {
+      cabecalho  += "; Intervalo;";
+      cabecalho  += to_string(config->intervaloLog);
+   }
+   cabecalho  += "\n";
+
+   cabecalho  += "Ilhas;";
+   cabecalho  += to_string(config->numIlhas);
+   if (config->numIlhas > 1)
+   {
+      cabecalho  += "; Intervalo de Migração;";
+      cabecalho  += to_string(config->intervaloMigracao);
+      cabecalho  += "; Taxa de Migração;";
+      cabecalho  += to_string(config->taxaMigracao);
+      cabecalho  += "; Topologia;";
+      cabecalho  += to_string(config->topologiaMigracao);
+      cabecalho  += "; Transporte;";
+      cabecalho  += to_string(config->transporteMigracao);
+      if (config->transporteMigracao != TTransporte::transporteThreads)
+      {
+         cabecalho  += "; Ilha;";
+         cabecalho  += to_string(config->idIlha);
+         cabecalho  += "; Endereço;";
+         cabecalho  += config->enderecoMigracao;
+      }
+   }
+   cabecalho  += "\n";
+
+   arqSaida = new TArqLog(cabecalho, nomeArqSaida);
+
+   if ((config->numIlhas > 1)&&(config->transporteMigracao != TTransporte::transporteThreads))
+   {
+      //Uma ilha por processo; os demais processos são iniciados à parte,
+      //com o mesmo numIlhas e um idIlha diferente. A instância é
+      //compartilhada entre eles pelo binário mapeado (cacheBinario)
+      vector <TAlgGenetico *> ags;
+      TTransporte *transporte;
+
+      if (config->transporteMigracao == TTransporte::transporteMemoria)
+         transporte = new TTransporteMemoria(config->enderecoMigracao, config->numIlhas, mapa->get_qtdeGenes(), mapa->assinatura());
+      else
+         transporte = new TTransporteSocket(config->enderecoMigracao, config->idIlha, config->numIlhas, mapa->get_qtdeGenes());
+
+      //Sem transporte a ilha evoluiria isolada, sem aviso: não inicia
+      if (!transporte->ativo())
+      {
+         printf("Erro: transporte de migração indisponível, ilha %d não iniciada\n", config->idIlha);
+         delete transporte;
+         delete arqSaida;
+         exit(1);
+      }
+
+      ags.push_back(criaAG(config, mapa, arqSaida));
+      ilhas = new TIlhas(ags, config->idIlha, config->numIlhas, transporte, arqSaida,
+                         config->intervaloMigracao, config->taxaMigracao, config->topologiaMigracao);
+      ilhas->exec();
+      delete ilhas;
+   }
+   else if (config->numIlhas > 1)
+   {
+      //Cada ilha tem o seu arquivo de saída, com as gerações dela. No
+      //arquivo principal fica o resumo das ilhas
+      vector <TAlgGenetico *> ags;
+      vector <TArqLog *> arqIlhas;
+
+      for (int i=0; i<config->numIlhas; i++)
+      {
+         string nomeArqIlha = nomeArqSaida.substr(0, nomeArqSaida.size()-4);
+         nomeArqIlha += "_ilha";
+         nomeArqIlha += to_string(i);
+         nomeArqIlha += ".txt";
+
+         arqIlhas.push_back(new TArqLog(cabecalho + "Ilha;" + to_string(i) + "\n", nomeArqIlha));
+         ag = criaAG(config, mapa, arqIlhas[i]);
+         if (i > 0) ag->setPrintParcial(0);
+         ags.push_back(ag);
+      }
+
+      ilhas = new TIlhas(ags, 0, config->numIlhas, new TTransporteLocal(config->numIlhas, mapa->get_qtdeGenes()), arqSaida,
+                         config->intervaloMigracao, config->taxaMigracao, config->topologiaMigracao);
+      ilhas->exec();
+      delete ilhas;
+
+      for (unsigned i=0; i<arqIlhas.size(); i++)
+         delete arqIlhas[i];
+   }
+   else
+   {
+      ag = criaAG(config, mapa, arqSaida);
+      ag->exec();
+      delete ag;
+   }
+
+   arqSaida->addLinha("");
+   arqSaida->addLinha("");
+
+   delete arqSaida;
+}
+
+int main(int argc, char *argv[])
+{
+   TMapaGenes *mapa = new TMapaGenes();
+   TConfig *config  = new TConfig();
+   int jobs = 1;
+   uint64_t semente = TUtils::sementeAleatoria();
+   int nivelLog = -1;
+
    //parâmetros obrigatóros como entrada
    if (argc < 4)
    {
       cout << "Parâmetros obrigatóros:" << endl;
-      cout << "\t 1 - Arquivo de instância TSP, no formato XML" << endl;
+      cout << "\t 1 - Arquivo de instância TSP, no formato XML, TSPLIB (.tsp) ou binário (.bin)" << endl;
       cout << "\t 2 - Arquivo de configuração, no formato XML" << endl;
       cout << "\t 3 - Nome do arquivo de saída, resultados" << endl;
+      cout << "Opções:" << endl;
+      cout << "\t --jobs N - Quantidade de execuções (numExec) simultâneas" << endl;
+      cout << "\t --seed N - Semente do gerador aleatório (padrão: sorteada)" << endl;
+      cout << "\t --log N  - Nível de log, no lugar do nivelLog da configuração" << endl;
       return 1;
    }
 
+   for (int i=4; i<argc; i++)
+   {
+      string opcao = argv[i];
+
+      if ((opcao == "--jobs")&&(i+1 < argc)) jobs = atoi(argv[++i]);
+      else if (opcao.compare(0, 7, "--jobs=") == 0) jobs = atoi(opcao.substr(7).c_str());
+      else if ((opcao == "--seed")&&(i+1 < argc)) semente = strtoull(argv[++i], NULL, 10);
+      else if (opcao.compare(0, 7, "--seed=") == 0) semente = strtoull(opcao.substr(7).c_str(), NULL, 10);
+      else if ((opcao == "--log")&&(i+1 < argc)) nivelLog = atoi(argv[++i]);
+      else if (opcao.compare(0, 6, "--log=") == 0) nivelLog = atoi(opcao.substr(6).c_str());
+      else
+      {
+         printf("Erro: opção inválida %s\n", argv[i]);
+         return 1;
+      }
+   }
+
    LIBXML_TEST_VERSION
 
    cout << "Caregando arquivo de configuração: " << argv[2] << endl;
    config->carregaDoArquivo(argv[2]);
    cout << "Arquivo " << argv[2] << " carregado." << endl;
 
+   //A linha de comando prevalece sobre o arquivo de configuração
+   if (nivelLog >= 0) config->nivelLog = nivelLog;
+
+   if ((config->numIlhas > 1)&&((config->idIlha < 0)||(config->idIlha >= config->numIlhas)))
+   {
+      printf("Erro: idIlha %d fora do intervalo 0 a %d\n", config->idIlha, config->numIlhas-1);
+      return 1;
+   }
+
+   if (jobs < 1)
+   {
+      printf("Erro: --jobs deve ser 1 ou mais\n");
+      return 1;
+   }
+
+   //As execuções simultâneas usariam a mesma memória compartilhada / socket
+   if ((jobs > 1)&&(config->numIlhas > 1)&&(config->transporteMigracao != TTransporte::transporteThreads))
+   {
+      cout << "Ilhas em processos: --jobs ignorado" << endl;
+      jobs = 1;
+   }
+
+   //Sem paralelismo aninhado as regiões internas (ilhas em threads,
+   //descendentes, mutações e tarefas recursivas) rodariam com uma thread
+   //dentro de cada execução simultânea, e as ilhas ficariam em sequência
+   if ((jobs > 1)&&((config->numIlhas > 1)||(config->numThreads > 0)))
+   {
+      cout << "Ilhas ou numThreads na configuração: --jobs ignorado" << endl;
+      jobs = 1;
+   }
+
    cout << "Caregando instância " << argv[1] << endl;
+   mapa->set_armazenamento(config->armazenamentoMapa);
+   mapa->set_cacheBinario(config->cacheBinario);
+   mapa->set_qtdeVizinhos(config->qtdeVizinhos);
    mapa->carregaDoArquivo (argv[1]);
+   if (mapa->get_qtdeGenes() <= 0)
+   {
+      printf("Erro: instância %s não carregada\n", argv[1]);
+      return 1;
+   }
    cout << "Instância " << argv[1] << " carregada." << endl;
 
-   TUtils::initRnd ();
+   TUtils::initRnd (semente);
 
+   //Cada execução tem o seu gerador, com a semente e o número dela, assim
+   //cada uma pode ser repetida sozinha e o resultado não depende de jobs
+   #pragma omp parallel for schedule(dynamic) num_threads(jobs)
    for (int countExec=0; countExec<config->numExec; countExec++)
    {
-      /* para complemento do nome do arquivo de saida */
-      tempo = time(0);
-      tlocal = localtime(&tempo);
-      strftime(data, 128, "%d_%m_%y_%H_%M_%S", tlocal);
-      nomeArqSaida = argv[3];
-      nomeArqSaida += "_";
-      nomeArqSaida += to_string(countExec);
-      nomeArqSaida += "_";
-      nomeArqSaida += data;
-      nomeArqSaida += ".txt";
-
-      if (config->printParcial)
-      {
-         cout << "Execução " << countExec+1 << " / " << config->numExec << " iniciada. "<< endl;
-         cout << "Arquivo de saida de resultados: " << nomeArqSaida << endl;
-      }
-
-      cabecalho   = "Instância;";
-      cabecalho  +=  argv[1];
-      cabecalho  +=  "\n";
-
-      cabecalho  += "Execução;";
-      cabecalho  += to_string(countExec+1);
-      cabecalho  += " / ";
-      cabecalho  += to_string(config->numExec);
-      cabecalho  += "\n";
-
-      cabecalho  += "Tamanho da Populaçap;";
-      cabecalho  += to_string(config->tamPopulacao);
-      cabecalho  += "\n";
-
-      cabecalho  += "Máximo de gerações;";
-      cabecalho  += to_string(config->maxGeracao);
-      cabecalho  += "\n";
-
-      cabecalho  += "Mutação;";
-      cabecalho  += to_string(config->mutacao);
-      cabecalho  += "\n";
-
-      cabecalho  += "Cruzamento;";
-      cabecalho  += to_string(config->cruzamento);
-      cabecalho  += "\n";
-
-      cabecalho  += "% Manpulação;";
-      cabecalho  += to_string(config->percentManipulacao);
-      cabecalho  += "\n";
-
-      cabecalho  += "% Mutação;";
-      cabecalho  += to_string(config->percentMutacao);
-      cabecalho  += "\n";
-
-      cabecalho  += "Print Parcial;";
-      cabecalho  += to_string(config->printParcial);
-      cabecalho  += "\n";
-
-      cabecalho  += "Ativa Recursivo;";
-      cabecalho  += to_string(config->percentMutacaoRecursiva);
-      cabecalho  += "\n";
-
-      cabecalho  += "Percentual de Redução;";
-      cabecalho  += to_string(config->percentReducao);
-      cabecalho  += "\n";
-
-      cabecalho  += "Profundidade Máxima;";
-      cabecalho  += to_string(config->profundidadeMaxima);
-      cabecalho  += "\n";
-
-      cabecalho  += "Percentual de Eltismo;";
-      cabecalho  += to_string(config->percentElitismo);
-      cabecalho  += "\n";
-
-      cabecalho  += "Seleção para Cruzamento;";
-      cabecalho  += to_string(config->selecao);
-      cabecalho  += "\n";
-
-      cabecalho  += "Forma de Seleção par Mutação;";
-      cabecalho  += to_string(config->selIndMutacao);
-      cabecalho  += "\n";
-
-      arqSaida = new TArqLog(cabecalho, nomeArqSaida);
-      ag = new TAlgGenetico(mapa, arqSaida);
-      ag->setMutacao(config->mutacao);
-      ag->setCruzamento(config->cruzamento);
-      ag->setTamPopulacao(config->tamPopulacao);
-      ag->setPrintParcial(config->printParcial);
-      ag->setMaxGeracao(config->maxGeracao);
-      ag->setPercentElitismo(config->percentElitismo);
-      ag->setPercentMutacao(config->percentMutacao);
-	   ag->setProfundidadeMaxima(config->profundidadeMaxima);
-      ag->setSelecao(config->selecao);
-      ag->setSelIndMutacao(config->selIndMutacao);
-      ag->setPercentMutacaoRecursiva(config->percentMutacaoRecursiva);
-      ag->setPercentReducao(config->percentReducao);
-      ag->exec();
-
-      arqSaida->addLinha("");
-      arqSaida->addLinha("");
+      TGerador gerador(semente, countExec);
 
-      delete arqSaida;
-      delete ag;
+      TUtils::set_gerador(&gerador);
+      executa(config, mapa, countExec, argv[1], argv[3]);
+      TUtils::set_gerador(NULL);
    }
 
    delete config;
@@ -300,17 +300,17 @@ int TMutacao::threeOPT(TIndividuo *individuo)
             TGene *gKmas1 = individuo->get_por_indice(Kmas1);
 
             //operação 1
-            gainActual = VP_Mapa->get_distancia(gi->ori, gImas1->dest) +
-                         VP_Mapa->get_distancia(gj->ori, gJmas1->dest) +
-                         VP_Mapa->get_distancia(gk->ori, gKmas1->dest);
+            gainActual = VP_Mapa->get_dist(gi->ori, gImas1->dest) +
+                         VP_Mapa->get_dist(gj->ori, gJmas1->dest) +
+                         VP_Mapa->get_dist(gk->ori, gKmas1->dest);
 
-            gainCandidato = VP_Mapa->get_distancia(gi->ori, gj->dest) +
-                            VP_Mapa->get_distancia(gImas1->ori, gk->dest) +
-                            VP_Mapa->get_distancia(gJmas1->ori, gKmas1->dest);
+            gainCandidato = VP_Mapa->get_dist(gi->ori, gj->dest) +
+                            VP_Mapa->get_dist(gImas1->ori, gk->dest) +
+                            VP_Mapa->get_dist(gJmas1->ori, gKmas1->dest);
 
             diff = valor - gainActual + gainCandidato + 
-				       this->calcValReverso(gImas1, gj) +
-				       this->calcValReverso(gJmas1, gk);
+				       this->calcValReverso(individuo, gImas1, gj) +
+				       this->calcValReverso(individuo, gJmas1, gk);
 
             if(min > diff)
             {
@@ -322,9 +322,9 @@ int TMutacao::threeOPT(TIndividuo *individuo)
             }
 
             //operação 2
-            gainCandidato = VP_Mapa->get_distancia(gi->ori, gJmas1->dest) +
-                            VP_Mapa->get_distancia(gk->ori, gImas1->dest) +
-                            VP_Mapa->get_distancia(gj->ori, gKmas1->dest);
+            gainCandidato = VP_Mapa->get_dist(gi->ori, gJmas1->dest) +
+                            VP_Mapa->get_dist(gk->ori, gImas1->dest) +
+                            VP_Mapa->get_dist(gj->ori, gKmas1->dest);
 
             diff = valor - gainActual + gainCandidato;
 
@@ -338,12 +338,12 @@ int TMutacao::threeOPT(TIndividuo *individuo)
             }
 
             //operação 3
-            gainCandidato = VP_Mapa->get_distancia(gi->ori, gk->dest) +
-                            VP_Mapa->get_distancia(gJmas1->ori, gImas1->dest) +
-                            VP_Mapa->get_distancia(gj->ori, gKmas1->dest);
+            gainCandidato = VP_Mapa->get_dist(gi->ori, gk->dest) +
+                            VP_Mapa->get_dist(gJmas1->ori, gImas1->dest) +
+                            VP_Mapa->get_dist(gj->ori, gKmas1->dest);
 
             diff = valor - gainActual + gainCandidato +
-                   this->calcValReverso(gJmas1, gk);
+                   this->calcValReverso(individuo, gJmas1, gk);
 
             if(min > diff)
             {
@@ -355,12 +355,12 @@ int TMutacao::threeOPT(TIndividuo *individuo)
             }
 
             //operação 4
-            gainCandidato = VP_Mapa->get_distancia(gi->ori, gJmas1->dest) +
-                            VP_Mapa->get_distancia(gk->ori, gj->dest) +
-                            VP_Mapa->get_distancia(gImas1->ori, gKmas1->dest);
+            gainCandidato = VP_Mapa->get_dist(gi->ori, gJmas1->dest) +
+                            VP_Mapa->get_dist(gk->ori, gj->dest) +
+                            VP_Mapa->get_dist(gImas1->ori, gKmas1->dest);
 
             diff = valor - gainActual + gainCandidato +
-				       this->calcValReverso(gImas1, gj);
+				       this->calcValReverso(individuo, gImas1, gj);
 
             if(min > diff)
             {
@@ -457,18 +457,18 @@ int TMutacao::threeOPT2(TIndividuo *individuo)
             TGene *gKmas1 = individuo->get_por_indice(Kmas1);
 
             //operação 1
-            gainActual = VP_Mapa->get_distancia(gi->ori, gImas1->dest) +
-                         VP_Mapa->get_distancia(gj->ori, gJmas1->dest) +
-                         VP_Mapa->get_distancia(gk->ori, gKmas1->dest);
+            gainActual = VP_Mapa->get_dist(gi->ori, gImas1->dest) +
+                         VP_Mapa->get_dist(gj->ori, gJmas1->dest) +
+                         VP_Mapa->get_dist(gk->ori, gKmas1->dest);
 
-            gainCandidato = VP_Mapa->get_distancia(gi->ori, gj->dest) +
-                            VP_Mapa->get_distancia(gImas1->ori, gk->dest) +
-                            VP_Mapa->get_distancia(gJmas1->ori, gKmas1->dest);
+            gainCandidato = VP_Mapa->get_dist(gi->ori, gj->dest) +
+                            VP_Mapa->get_dist(gImas1->ori, gk->dest) +
+                            VP_Mapa->get_dist(gJmas1->ori, gKmas1->dest);
 
 
             diff = valor - gainActual + gainCandidato + 
-			          this->calcValReverso(gImas1, gj) +
-				       this->calcValReverso(gJmas1, gk);
+			          this->calcValReverso(individuo, gImas1, gj) +
+				       this->calcValReverso(individuo, gJmas1, gk);
 
             if(min > diff)
             {
@@ -477,9 +477,9 @@ int TMutacao::threeOPT2(TIndividuo *individuo)
             }
 
             //operação 2
-            gainCandidato = VP_Mapa->get_distancia(gi->ori, gJmas1->dest) +
-                            VP_Mapa->get_distancia(gk->ori, gImas1->dest) +
-                            VP_Mapa->get_distancia(gj->ori, gKmas1->dest);
+            gainCandidato = VP_Mapa->get_dist(gi->ori, gJmas1->dest) +
+                            VP_Mapa->get_dist(gk->ori, gImas1->dest) +
+                            VP_Mapa->get_dist(gj->ori, gKmas1->dest);
 
             diff = valor - gainActual + gainCandidato;
 
@@ -490,12 +490,12 @@ int TMutacao::threeOPT2(TIndividuo *individuo)
             }
 
             //operação 3
-            gainCandidato = VP_Mapa->get_distancia(gi->ori, gk->dest) +
-                            VP_Mapa->get_distancia(gJmas1->ori, gImas1->dest) +
-                            VP_Mapa->get_distancia(gj->ori, gKmas1->dest);
+            gainCandidato = VP_Mapa->get_dist(gi->ori, gk->dest) +
+                            VP_Mapa->get_dist(gJmas1->ori, gImas1->dest) +
+                            VP_Mapa->get_dist(gj->ori, gKmas1->dest);
 
             diff = valor - gainActual + gainCandidato +
-                   this->calcValReverso(gJmas1, gk);
+                   this->calcValReverso(individuo, gJmas1, gk);
 				   
             if(min > diff)
             {
@@ -504,12 +504,12 @@ int TMutacao::threeOPT2(TIndividuo *individuo)
             }
 
             //operação 4
-            gainCandidato = VP_Mapa->get_distancia(gi->ori, gJmas1->dest) +
-                            VP_Mapa->get_distancia(gk->ori, gj->dest) +
-                            VP_Mapa->get_distancia(gImas1->ori, gKmas1->dest);
+            gainCandidato = VP_Mapa->get_dist(gi->ori, gJmas1->dest) +
+                            VP_Mapa->get_dist(gk->ori, gj->dest) +
+                            VP_Mapa->get_dist(gImas1->ori, gKmas1->dest);
 
             diff = valor - gainActual + gainCandidato +
-                   this->calcValReverso(gImas1, gj);
+                   this->calcValReverso(individuo, gImas1, gj);
 
             if(min > diff)
             {
@@ -735,9 +735,11 @@ int TMutacao::HM(TIndividuo *individuo)
     GenesPointer.push_back(individuo->get_por_indice(idx));
   }
 
+  //O clone é reaproveitado: a cópia não aloca memória
+  Clone = individuo->clona();
   do
   {
-    Clone = individuo->clona();
+    *Clone = *individuo;
     
     for(unsigned i = 0; i < Indexes.size(); i++)
     {
@@ -758,6 +760,7 @@ int TMutacao::HM(TIndividuo *individuo)
       *individuo = *Clone;
     }
   } while(next_permutation(Indexes.begin(), Indexes.end()));
+  delete Clone;
   return 1;
 }
 
@@ -913,13 +916,15 @@ int TMutacao::NJ(TIndividuo *individuo, TPopulacao *populacao)
   {
     return 0;
   }
+  for(int i=0; i<4; i++) opcoes[i] = individuo->clona();
+
   for(int interacao=0; interacao<nMaxInteracoes; interacao++)
   {
     //Opções de indivíduos a ser escolhida
-    opcoes[0] = individuo->clona();
-    opcoes[1] = individuo->clona();
-    opcoes[2] = individuo->clona();
-    opcoes[3] = individuo->clona();
+    *opcoes[0] = *individuo;
+    *opcoes[1] = *individuo;
+    *opcoes[2] = *individuo;
+    *opcoes[3] = *individuo;
 
     //seleciona o gene c.
     c = individuo->get_por_indice(TUtils::rnd(1, individuo->get_qtdeGenes()-1));
@@ -939,18 +944,28 @@ int TMutacao::NJ(TIndividuo *individuo, TPopulacao *populacao)
     else
     {
       //Pega no individuo o id do gene que tem a menor distancia possivel com c dentro do mapa.
-      vector< pair<int, double>> distancias;
-      for(int i=1; i<individuo->get_qtdeGenes(); i++)
+      //Se os genes são as cidades, usa a lista de vizinhos já ordenada do mapa
+      if ((individuo->is_genesCidades())&&(mapaGenes->is_simetrico())
+          &&(mapaGenes->get_qtdeVizinhos() >= min(nMaxVizinhos, individuo->get_qtdeGenes()-2)))
+      {
+        rndi = TUtils::rnd(0, min(nMaxVizinhos, mapaGenes->get_qtdeVizinhos())-1);
+        cLinha = individuo->get_por_id(mapaGenes->get_vizinhos(c->id)[rndi]);
+      }
+      else
       {
-        if(i!=c->id)
+        vector< pair<int, double>> distancias;
+        for(int i=1; i<individuo->get_qtdeGenes(); i++)
         {
-          pair<int, double> dist(i, mapaGenes->get_distancia(i, c->id));
-          distancias.push_back(dist);
+          if(i!=c->id)
+          {
+            pair<int, double> dist(i, mapaGenes->get_dist(i, c->id));
+            distancias.push_back(dist);
+          }
         }
+        sort(distancias.begin(), distancias.end(), TUtils::compare_pair_second<int, double, std::less<double>>());
+        rndi = TUtils::rnd(0, nMaxVizinhos-1);
+        cLinha = individuo->get_por_id(distancias[rndi].first);
       }
-      sort(distancias.begin(), distancias.end(), TUtils::compare_pair_second<int, double, std::less<double>>());
-      rndi = TUtils::rnd(0, nMaxVizinhos-1);
-      cLinha = individuo->get_por_id(distancias[rndi].first);
     }
     //Se são visinhos, pula a interação;
     if(c->prox == cLinha || c->ant == cLinha)
@@ -993,20 +1008,17 @@ int TMutacao::NJ(TIndividuo *individuo, TPopulacao *populacao)
       }
     }
   }
+
+  for(int i=0; i<4; i++) delete opcoes[i];
+  free(opcoes);
   return 1;
 }
 
 /*************************
 *  Métodos auxiliares
 *************************/
-double TMutacao::calcValReverso (TGene *g1, TGene *g2)
+double TMutacao::calcValReverso (TIndividuo *individuo, TGene *g1, TGene *g2)
 {
-	double resultado = 0;
-	for (TGene *aux = g1; aux->id != g2->id; aux = aux->prox)
-	{
-		resultado -= VP_Mapa->get_distancia(aux->ori, aux->prox->dest);
-		resultado += VP_Mapa->get_distancia(aux->prox->ori, aux->dest);
-	}
-	
-	return resultado;
+	//Zero no mapa simétrico. Nos demais, pelos custos acumulados do indivíduo
+	return individuo->get_dif_reverso(g1, g2);
 }
\ No newline at end of file
@@ -59,7 +59,7 @@ class TMutacao
       //NJ precisa de um ponteiro para a populacao!!
       int NJ(TIndividuo *individuo, TPopulacao *populacao);
 	  //Métodos auxiliares
-      double calcValReverso (TGene *g1, TGene *g2);
+      double calcValReverso (TIndividuo *individuo, TGene *g1, TGene *g2);
       void Tipo3(TIndividuo *opcao, TGene *c, TGene *cLinha);
       void Tipo4(TIndividuo *opcao, TGene *c, TGene *cLinha);
 };
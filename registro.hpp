@@ -0,0 +1,52 @@
+/*
+*  registro.hpp
+*
+*  Módulo responsável pelo formato binário do rastro das gerações. Cada
+*  geração, em qualquer profundidade, vira um registro de tamanho fixo no
+*  arquivo .trc, no lugar da linha ;Profundidade;...;Tempo; do log texto.
+*  O tspconv converte o arquivo de volta para texto
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 17/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#ifndef _REGISTRO_H
+#define	_REGISTRO_H
+
+#include <stdint.h>
+
+//Os campos estão em ordem decrescente de tamanho, sem enchimento entre eles.
+//Inteiros e reais na ordem de bytes da máquina que gravou
+struct TRegistroGeracao
+{
+   double   melhor;
+   double   pior;
+   double   media;
+   int64_t  tempo;        //ns do relógio monotônico (o início está no cabeçalho)
+   int32_t  geracao;
+   int32_t  profundidade;
+   uint32_t entradas;     //contadores da recursão do AG, até esta geração
+   uint32_t execucoes;
+   uint32_t combinacoes;
+   uint32_t reservado;
+};
+
+//Cabeçalho do arquivo, seguido dos registros. É gravado no início do AG,
+//logo após o sysTime1, para que o Tempo seja contado a partir dele como no
+//log texto
+struct TCabecalhoRegistros
+{
+   char     assinatura[8];   //"TSPTRC2"
+   int64_t  inicio;          //ns do relógio monotônico no início do AG
+   uint32_t tamRegistro;     //sizeof(TRegistroGeracao), para conferência
+   uint32_t maxGeracao;      //para o "Geração X / Y:" do log texto
+   int64_t  inicioExecucao;  //sysTime1 do AG: time() no início, em s
+   int64_t  inicioReal;      //ns do relógio de parede no mesmo instante de inicio
+};
+
+static const char assinaturaRegistros[8] = "TSPTRC2";
+
+#endif
@@ -61,6 +61,35 @@ vector<TTipoConversao> TTabConversao::get_vetConv()
    return VP_tabConv;
 }
 
+void TTabConversao::preencheMapaReduzido(TMapaGenes *mapa, TMapaGenes *reduzido)
+{
+   int k = VP_tabConv.size();
+
+   reduzido->inicializa(k);
+
+   for (int i=0; i<k; i++)
+      for (int j=0; j<k; j++)
+         if (i!=j) reduzido->set_distancia(i, j, mapa->get_dist(VP_tabConv[i].ulOrig, VP_tabConv[j].prDest));
+
+   //Mantém a matriz completa, apenas verificando a simetria
+   reduzido->set_armazenamento(TMapaGenes::armazenaCompleto);
+   reduzido->defineArmazenamento();
+   reduzido->set_qtdeVizinhos(mapa->get_qtdeVizinhos());
+   reduzido->geraVizinhos();
+}
+
+vector<TTipoConversao> TTabConversao::get_vetIdentidade()
+{
+   vector<TTipoConversao> identidade(VP_tabConv.size());
+
+   for (unsigned i=0; i<identidade.size(); i++)
+   {
+      identidade[i].pr = identidade[i].prOrig = identidade[i].prDest = i;
+      identidade[i].ul = identidade[i].ulOrig = identidade[i].ulDest = i;
+   }
+   return identidade;
+}
+
 string TTabConversao::toString()
 {
    string resultado = "";
@@ -85,17 +114,25 @@ string TTabConversao::toString()
 	
 void TTabConversao::converte(TIndividuo *individuo, TIndividuo *indReduzido)
 {
-   TGene *gIR;
+   vector<int> ordem(indReduzido->get_qtdeGenes());
+
+   for (int i=0; i< indReduzido->get_qtdeGenes(); i++)
+      ordem[i] = indReduzido->get_por_indice(i)->id;
+
+   converte(individuo, ordem);
+}
+
+void TTabConversao::converte(TIndividuo *individuo, const vector<int> &ordem)
+{
    TTipoConversao c;
    TGene *gI;
    TGene *gTemp;
-   int aux[individuo->get_qtdeGenes()];
+   vector<int> aux(individuo->get_qtdeGenes());
    int indG;
    indG = 0;
-   for (int i=0; i< indReduzido->get_qtdeGenes(); i++)
+   for (unsigned i=0; i< ordem.size(); i++)
    {
-      gIR = indReduzido->get_por_indice(i);
-	  c = VP_tabConv[gIR->id];
+	  c = VP_tabConv[ordem[i]];
       gI = individuo->get_por_id(c.pr); 
 
 	  do
@@ -113,4 +150,21 @@ void TTabConversao::converte(TIndividuo *individuo, TIndividuo *indReduzido)
       if (gI->id!=aux[i])
 	     individuo->troca (gI->id, aux[i]);
    }
-}
\ No newline at end of file
+}
+
+vector<int> TTabConversao::get_ordem(TIndividuo *individuo)
+{
+   vector<int> fragmento(individuo->get_qtdeGenes(), -1);
+   vector<int> ordem;
+   int id;
+
+   for (unsigned i=0; i<VP_tabConv.size(); i++)
+      fragmento[VP_tabConv[i].pr] = i;
+
+   for (int i=0; i<individuo->get_qtdeGenes(); i++)
+   {
+      id = individuo->get_por_indice(i)->id;
+      if (fragmento[id] >= 0) ordem.push_back(fragmento[id]);
+   }
+   return ordem;
+}
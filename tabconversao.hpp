@@ -25,11 +25,24 @@ class TTabConversao
       vector<TTipoConversao> VP_tabConv;
 
    public:
+      //Até este tamanho, a recursão trabalha com um mapa reduzido próprio
+      //(k x k doubles, 512 KB no limite), em vez do mapa completo
+      static const int limiteMapaReduzido = 256;
+
       TTabConversao(TIndividuo *melhor, TIndividuo *select);
       ~TTabConversao();
 	  int get_quantidade();
 	  vector<TTipoConversao> get_vetConv();
+	  //Monta em reduzido o mapa denso k x k entre os fragmentos:
+	  //distância do fim de i ao início de j
+	  void preencheMapaReduzido(TMapaGenes *mapa, TMapaGenes *reduzido);
+	  //Conversão para uso com o mapa reduzido: cada fragmento é um gene
+	  vector<TTipoConversao> get_vetIdentidade();
 	  void converte(TIndividuo *individuo, TIndividuo *indReduzido);
+	  //Monta o indivíduo com os fragmentos na ordem informada
+	  void converte(TIndividuo *individuo, const vector<int> &ordem);
+	  //Ordem em que os fragmentos aparecem no indivíduo
+	  vector<int> get_ordem(TIndividuo *individuo);
 	  string toString();
 };
 
@@ -0,0 +1,420 @@
+/*
+*  transporte.cpp
+*
+*  Módulo responsável pelo transporte dos migrantes entre as ilhas.
+*  Um migrante é enviado como o vetor de ids da rota mais o seu custo.
+*  Há transporte entre threads do mesmo processo, por memória
+*  compartilhada (processos na mesma máquina) e por socket (Unix ou UDP)
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 16/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#include "transporte.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+
+/*************************************************************************/
+TTransporte::TTransporte (int qtdeIlhas, int qtdeGenes)
+{
+   VP_qtdeIlhas = qtdeIlhas;
+   VP_qtdeGenes = qtdeGenes;
+}
+
+TTransporte::~TTransporte () {}
+
+bool TTransporte::rotaValida (const int *ids)
+{
+   vector<bool> visto(VP_qtdeGenes, false);
+
+   for (int i=0; i<VP_qtdeGenes; i++)
+   {
+      if ((ids[i] < 0)||(ids[i] >= VP_qtdeGenes)||visto[ids[i]]) return false;
+      visto[ids[i]] = true;
+   }
+   return true;
+}
+
+/*************************************************************************/
+TCanalMigracao::TCanalMigracao ()
+{
+   VP_cabeca = 0;
+   VP_cauda  = 0;
+}
+
+bool TCanalMigracao::envia (const int *ids, int qtde, double custo)
+{
+   unsigned cauda = VP_cauda.load(memory_order_relaxed);
+
+   if (cauda - VP_cabeca.load(memory_order_acquire) >= capacidade) return false;
+
+   TMigrante &m = VP_itens[cauda & (capacidade-1)];
+   m.custo = custo;
+   m.ids.assign(ids, ids + qtde);
+   VP_cauda.store(cauda+1, memory_order_release);
+   return true;
+}
+
+bool TCanalMigracao::recebe (int *ids, double &custo)
+{
+   unsigned cabeca = VP_cabeca.load(memory_order_relaxed);
+
+   if (cabeca == VP_cauda.load(memory_order_acquire)) return false;
+
+   TMigrante &m = VP_itens[cabeca & (capacidade-1)];
+   custo = m.custo;
+   memcpy(ids, m.ids.data(), m.ids.size()*sizeof(int));
+   VP_cabeca.store(cabeca+1, memory_order_release);
+   return true;
+}
+
+/*************************************************************************/
+TTransporteLocal::TTransporteLocal (int qtdeIlhas, int qtdeGenes) : TTransporte(qtdeIlhas, qtdeGenes)
+{
+   VP_canais.resize(qtdeIlhas * qtdeIlhas, NULL);
+   for (int o=0; o<qtdeIlhas; o++)
+      for (int d=0; d<qtdeIlhas; d++)
+         if (o != d) VP_canais[o*qtdeIlhas + d] = new TCanalMigracao();
+}
+
+TTransporteLocal::~TTransporteLocal ()
+{
+   for (unsigned i=0; i<VP_canais.size(); i++)
+      delete VP_canais[i];
+}
+
+bool TTransporteLocal::envia (int origem, int destino, const int *ids, double custo)
+{
+   return VP_canais[origem*VP_qtdeIlhas + destino]->envia(ids, VP_qtdeGenes, custo);
+}
+
+bool TTransporteLocal::recebe (int destino, int *ids, double &custo)
+{
+   for (int o=0; o<VP_qtdeIlhas; o++)
+      if ((o != destino)&&VP_canais[o*VP_qtdeIlhas + destino]->recebe(ids, custo))
+         return true;
+
+   return false;
+}
+
+/*************************************************************************/
+//Segmento: cabeçalho (64 bytes, assinatura no início) + qtdeIlhas² filas
+//Fila: cabeça e cauda (64 bytes) + capacidade slots
+//Slot: custo (double) + ids (qtdeGenes int)
+static const size_t tamCabecalhoMemoria = 64;
+
+TTransporteMemoria::TTransporteMemoria (string nome, int qtdeIlhas, int qtdeGenes, uint64_t assinatura) : TTransporte(qtdeIlhas, qtdeGenes)
+{
+   int fd;
+   struct stat info;
+   atomic<uint64_t> *cabecalho;
+   uint64_t esperado = 0;
+
+   VP_nome = nome;
+   VP_segmento = NULL;
+   VP_tamSlot = (sizeof(double) + qtdeGenes*sizeof(int) + 7) & ~(size_t)7;
+   VP_tamFila = (64 + capacidade*VP_tamSlot + 63) & ~(size_t)63;
+   VP_tamSegmento = tamCabecalhoMemoria + (size_t)qtdeIlhas*qtdeIlhas*VP_tamFila;
+
+   //A configuração toda entra na assinatura; 0 marca o segmento ainda livre
+   assinatura ^= ((uint64_t)qtdeIlhas << 32) ^ (uint64_t)qtdeGenes;
+   if (assinatura == 0) assinatura = 1;
+
+   //Só quem cria o segmento define o tamanho. Um ftruncate de quem chega
+   //depois poderia encolher um segmento já mapeado (SIGBUS nos outros)
+   fd = shm_open(VP_nome.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+   if (fd >= 0)
+   {
+      if (ftruncate(fd, VP_tamSegmento) != 0)
+      {
+         printf("Erro ao dimensionar a memória compartilhada %s\n", VP_nome.c_str());
+         close(fd);
+         shm_unlink(VP_nome.c_str());
+         return;
+      }
+   }
+   else if (errno == EEXIST)
+      fd = shm_open(VP_nome.c_str(), O_RDWR, 0600);
+
+   if (fd < 0)
+   {
+      printf("Erro ao abrir a memória compartilhada %s\n", VP_nome.c_str());
+      return;
+   }
+
+   //Quem abriu um segmento existente espera o criador dimensioná-lo (até 5s)
+   for (int t=0; (fstat(fd, &info) == 0)&&(info.st_size == 0)&&(t < 500); t++)
+      usleep(10000);
+
+   if ((fstat(fd, &info) != 0)||(info.st_size != (off_t) VP_tamSegmento))
+   {
+      printf("Erro: memória compartilhada %s com tamanho %ld, esperado %ld (em uso por outra configuração?)\n",
+             VP_nome.c_str(), (long) info.st_size, (long) VP_tamSegmento);
+      close(fd);
+      return;
+   }
+
+   void *p = mmap(NULL, VP_tamSegmento, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   if (p != MAP_FAILED) VP_segmento = (char *) p;
+   close(fd);
+
+   if (VP_segmento == NULL)
+   {
+      printf("Erro ao mapear a memória compartilhada %s\n", VP_nome.c_str());
+      return;
+   }
+
+   //O primeiro a chegar grava a assinatura; os demais conferem
+   cabecalho = (atomic<uint64_t> *) VP_segmento;
+   if ((!cabecalho->compare_exchange_strong(esperado, assinatura))&&(esperado != assinatura))
+   {
+      printf("Erro: memória compartilhada %s em uso por outra configuração\n", VP_nome.c_str());
+      munmap(VP_segmento, VP_tamSegmento);
+      VP_segmento = NULL;
+   }
+}
+
+TTransporteMemoria::~TTransporteMemoria ()
+{
+   if (VP_segmento == NULL) return;
+
+   munmap(VP_segmento, VP_tamSegmento);
+   //Quem já mapeou continua com acesso; o nome some na primeira ilha a terminar
+   shm_unlink(VP_nome.c_str());
+}
+
+char *TTransporteMemoria::fila (int origem, int destino)
+{
+   return VP_segmento + tamCabecalhoMemoria + (size_t)(origem*VP_qtdeIlhas + destino)*VP_tamFila;
+}
+
+bool TTransporteMemoria::envia (int origem, int destino, const int *ids, double custo)
+{
+   if (VP_segmento == NULL) return false;
+
+   char *f = fila(origem, destino);
+   atomic<unsigned> *cabeca = (atomic<unsigned> *) f;
+   atomic<unsigned> *cauda  = (atomic<unsigned> *) (f + 32);
+   unsigned c = cauda->load(memory_order_relaxed);
+
+   if (c - cabeca->load(memory_order_acquire) >= capacidade) return false;
+
+   char *slot = f + 64 + (c & (capacidade-1))*VP_tamSlot;
+   memcpy(slot, &custo, sizeof(double));
+   memcpy(slot + sizeof(double), ids, VP_qtdeGenes*sizeof(int));
+   cauda->store(c+1, memory_order_release);
+   return true;
+}
+
+bool TTransporteMemoria::recebe (int destino, int *ids, double &custo)
+{
+   if (VP_segmento == NULL) return false;
+
+   for (int o=0; o<VP_qtdeIlhas; o++)
+   {
+      if (o == destino) continue;
+
+      char *f = fila(o, destino);
+      atomic<unsigned> *cabeca = (atomic<unsigned> *) f;
+      atomic<unsigned> *cauda  = (atomic<unsigned> *) (f + 32);
+      unsigned c = cabeca->load(memory_order_relaxed);
+
+      if (c == cauda->load(memory_order_acquire)) continue;
+
+      char *slot = f + 64 + (c & (capacidade-1))*VP_tamSlot;
+      memcpy(&custo, slot, sizeof(double));
+      memcpy(ids, slot + sizeof(double), VP_qtdeGenes*sizeof(int));
+      cabeca->store(c+1, memory_order_release);
+
+      //Segmento de uma execução anterior interrompida pode ter lixo
+      if (rotaValida(ids)) return true;
+   }
+   return false;
+}
+
+/*************************************************************************/
+//Datagrama: origem (int), qtde de genes (int), custo (double), ids
+static const size_t tamCabecalhoSocket = 2*sizeof(int) + sizeof(double);
+static const size_t limiteUDP = 65507;
+
+TTransporteSocket::TTransporteSocket (string endereco, int ilha, int qtdeIlhas, int qtdeGenes) : TTransporte(qtdeIlhas, qtdeGenes)
+{
+   VP_socket = -1;
+   VP_avisoTamanho = false;
+   VP_buffer.resize(tamCabecalhoSocket + qtdeGenes*sizeof(int));
+   VP_destinos.resize(qtdeIlhas);
+   VP_tamDestinos.resize(qtdeIlhas, 0);
+
+   if (endereco.compare(0, 5, "unix:") == 0)
+   {
+      string prefixo = endereco.substr(5);
+
+      for (int i=0; i<qtdeIlhas; i++)
+      {
+         sockaddr_un *un = (sockaddr_un *) &VP_destinos[i];
+         string caminho = prefixo + to_string(i);
+
+         memset(un, 0, sizeof(sockaddr_un));
+         un->sun_family = AF_UNIX;
+         strncpy(un->sun_path, caminho.c_str(), sizeof(un->sun_path)-1);
+         VP_tamDestinos[i] = sizeof(sockaddr_un);
+      }
+
+      VP_caminho = prefixo + to_string(ilha);
+      unlink(VP_caminho.c_str());
+      VP_socket = socket(AF_UNIX, SOCK_DGRAM, 0);
+   }
+   else if (endereco.compare(0, 4, "udp:") == 0)
+   {
+      size_t sep = endereco.rfind(':');
+      string hosts = endereco.substr(4, sep-4);
+      int porta = atoi(endereco.substr(sep+1).c_str());
+      vector <string> lista;
+      size_t ini = 0;
+      size_t fim;
+
+      do
+      {
+         fim = hosts.find(',', ini);
+         lista.push_back(hosts.substr(ini, fim-ini));
+         ini = fim+1;
+      }while (fim != string::npos);
+
+      for (int i=0; i<qtdeIlhas; i++)
+      {
+         addrinfo dica;
+         addrinfo *res;
+         string host = lista[(lista.size() == 1)?0:i % lista.size()];
+
+         memset(&dica, 0, sizeof(dica));
+         dica.ai_family = AF_INET;
+         dica.ai_socktype = SOCK_DGRAM;
+         if (getaddrinfo(host.c_str(), to_string(porta+i).c_str(), &dica, &res) != 0)
+         {
+            printf("Erro ao resolver o endereço da ilha %d: %s\n", i, host.c_str());
+            continue;
+         }
+         memcpy(&VP_destinos[i], res->ai_addr, res->ai_addrlen);
+         VP_tamDestinos[i] = res->ai_addrlen;
+         freeaddrinfo(res);
+      }
+
+      //A ilha recebe em todas as interfaces, na sua porta
+      sockaddr_in *local = (sockaddr_in *) &VP_destinos[ilha];
+      local->sin_addr.s_addr = htonl(INADDR_ANY);
+      VP_socket = socket(AF_INET, SOCK_DGRAM, 0);
+   }
+   else
+   {
+      printf("Erro: endereço de migração inválido %s\n", endereco.c_str());
+      return;
+   }
+
+   if ((VP_socket < 0)||(bind(VP_socket, (sockaddr *) &VP_destinos[ilha], VP_tamDestinos[ilha]) != 0))
+   {
+      printf("Erro ao abrir o socket da ilha %d (%s)\n", ilha, endereco.c_str());
+      if (VP_socket >= 0) close(VP_socket);
+      VP_socket = -1;
+      return;
+   }
+
+   if (!cabeDatagrama(VP_destinos[ilha].ss_family == AF_UNIX))
+   {
+      close(VP_socket);
+      VP_socket = -1;
+   }
+}
+
+//O migrante inteiro precisa caber em um datagrama. No UDP o limite é fixo;
+//no Unix é o buffer de envio (menos 32 bytes), que é aumentado se preciso,
+//até o máximo do sistema (net.core.wmem_max)
+bool TTransporteSocket::cabeDatagrama (bool socketUnix)
+{
+   size_t tam = VP_buffer.size();
+   int buffer = 0;
+   socklen_t tamOpcao = sizeof(buffer);
+
+   if (!socketUnix)
+   {
+      if (tam <= limiteUDP) return true;
+      printf("Erro: migrante de %zu bytes (%d genes) excede o datagrama UDP (%zu bytes). Use o transporte 1 ou o 0\n",
+             tam, VP_qtdeGenes, limiteUDP);
+      return false;
+   }
+
+   getsockopt(VP_socket, SOL_SOCKET, SO_SNDBUF, &buffer, &tamOpcao);
+   if ((size_t) buffer < tam + 32)
+   {
+      //O kernel dobra o valor pedido
+      buffer = tam + 32;
+      setsockopt(VP_socket, SOL_SOCKET, SO_SNDBUF, &buffer, sizeof(buffer));
+      tamOpcao = sizeof(buffer);
+      getsockopt(VP_socket, SOL_SOCKET, SO_SNDBUF, &buffer, &tamOpcao);
+   }
+   if ((size_t) buffer >= tam + 32) return true;
+
+   printf("Erro: migrante de %zu bytes (%d genes) excede o buffer do socket Unix (%d bytes). "
+          "Aumente net.core.wmem_max ou use o transporte 1\n", tam, VP_qtdeGenes, buffer);
+   return false;
+}
+
+TTransporteSocket::~TTransporteSocket ()
+{
+   if (VP_socket >= 0) close(VP_socket);
+   if (!VP_caminho.empty()) unlink(VP_caminho.c_str());
+}
+
+bool TTransporteSocket::envia (int origem, int destino, const int *ids, double custo)
+{
+   if ((VP_socket < 0)||(VP_tamDestinos[destino] == 0)) return false;
+
+   char *b = VP_buffer.data();
+   memcpy(b, &origem, sizeof(int));
+   memcpy(b + sizeof(int), &VP_qtdeGenes, sizeof(int));
+   memcpy(b + 2*sizeof(int), &custo, sizeof(double));
+   memcpy(b + tamCabecalhoSocket, ids, VP_qtdeGenes*sizeof(int));
+
+   if (sendto(VP_socket, b, VP_buffer.size(), MSG_DONTWAIT,
+              (sockaddr *) &VP_destinos[destino], VP_tamDestinos[destino]) == (ssize_t) VP_buffer.size())
+      return true;
+
+   //Buffer cheio descarta o migrante em silêncio; tamanho não volta a caber
+   if ((errno == EMSGSIZE)&&(!VP_avisoTamanho))
+   {
+      printf("Erro: migrante de %zu bytes recusado pelo socket (EMSGSIZE); a ilha %d não envia migrantes\n",
+             VP_buffer.size(), origem);
+      VP_avisoTamanho = true;
+   }
+   return false;
+}
+
+bool TTransporteSocket::recebe (int destino, int *ids, double &custo)
+{
+   if (VP_socket < 0) return false;
+
+   char *b = VP_buffer.data();
+   ssize_t lidos;
+   int qtde;
+
+   while ((lidos = recv(VP_socket, b, VP_buffer.size(), MSG_DONTWAIT)) >= 0)
+   {
+      memcpy(&qtde, b + sizeof(int), sizeof(int));
+      if ((lidos != (ssize_t) VP_buffer.size())||(qtde != VP_qtdeGenes)) continue;
+
+      memcpy(&custo, b + 2*sizeof(int), sizeof(double));
+      memcpy(ids, b + tamCabecalhoSocket, VP_qtdeGenes*sizeof(int));
+      if (rotaValida(ids)) return true;
+   }
+   return false;
+}
@@ -0,0 +1,148 @@
+/*
+*  transporte.hpp
+*
+*  Módulo responsável pelo transporte dos migrantes entre as ilhas.
+*  Um migrante é enviado como o vetor de ids da rota mais o seu custo.
+*  Há transporte entre threads do mesmo processo, por memória
+*  compartilhada (processos na mesma máquina) e por socket (Unix ou UDP)
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 16/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#ifndef _TRANSPORTE_H
+#define	_TRANSPORTE_H
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <stdint.h>
+#include <sys/socket.h>
+
+using namespace std;
+
+class TTransporte
+{
+   public:
+      static const int transporteThreads  = 0;
+      static const int transporteMemoria  = 1;
+      static const int transporteSocket   = 2;
+
+   protected:
+      int VP_qtdeIlhas;
+      int VP_qtdeGenes;
+
+      //Confere se os ids recebidos formam uma rota (permutação) válida
+      bool rotaValida (const int *ids);
+
+   public:
+      TTransporte (int qtdeIlhas, int qtdeGenes);
+      virtual ~TTransporte ();
+
+      //Nenhum dos dois bloqueia. Retornam false se não houver espaço para
+      //o migrante / se não houver migrante para a ilha
+      virtual bool envia (int origem, int destino, const int *ids, double custo) = 0;
+      virtual bool recebe (int destino, int *ids, double &custo) = 0;
+
+      //false se o transporte não pôde ser aberto (a ilha não deve iniciar)
+      virtual bool ativo () { return true; }
+};
+
+//Fila circular sem trava com um único produtor e um único consumidor
+class TCanalMigracao
+{
+   private:
+      static const unsigned capacidade = 64;  //potência de 2
+
+      struct TMigrante
+      {
+         double custo;
+         vector<int> ids;
+      };
+
+      TMigrante VP_itens[capacidade];
+      atomic<unsigned> VP_cabeca;  //próximo a ser lido (consumidor)
+      atomic<unsigned> VP_cauda;   //próximo a ser escrito (produtor)
+
+   public:
+      TCanalMigracao ();
+
+      bool envia (const int *ids, int qtde, double custo);
+      bool recebe (int *ids, double &custo);
+};
+
+//Ilhas como threads de um mesmo processo: um canal por par ordenado
+class TTransporteLocal : public TTransporte
+{
+   private:
+      vector <TCanalMigracao *> VP_canais;  //[origem * qtdeIlhas + destino]
+
+   public:
+      TTransporteLocal (int qtdeIlhas, int qtdeGenes);
+      ~TTransporteLocal ();
+
+      bool envia (int origem, int destino, const int *ids, double custo);
+      bool recebe (int destino, int *ids, double &custo);
+};
+
+//Ilhas como processos na mesma máquina. O segmento (shm_open) tem uma fila
+//circular para cada par ordenado de ilhas; zerado é um estado válido
+//(filas vazias), então o primeiro processo a abrir só define o tamanho.
+//O cabeçalho guarda a assinatura da configuração (instância, ilhas e
+//genes), gravada por quem chegar primeiro e conferida pelos demais
+class TTransporteMemoria : public TTransporte
+{
+   private:
+      static const unsigned capacidade = 16;  //potência de 2
+
+      string VP_nome;
+      char *VP_segmento;
+      size_t VP_tamSegmento;
+      size_t VP_tamSlot;
+      size_t VP_tamFila;
+
+      //Início da fila de origem para destino
+      char *fila (int origem, int destino);
+
+   public:
+      TTransporteMemoria (string nome, int qtdeIlhas, int qtdeGenes, uint64_t assinatura);
+      ~TTransporteMemoria ();
+
+      bool envia (int origem, int destino, const int *ids, double custo);
+      bool recebe (int destino, int *ids, double &custo);
+      bool ativo () { return VP_segmento != NULL; }
+};
+
+//Ilhas como processos em uma ou mais máquinas, por datagramas. O endereço é
+//   unix:<prefixo>            ilha n em <prefixo><n>
+//   udp:<host>:<porta>        todas no mesmo host, ilha n na porta + n
+//   udp:<h0>,<h1>,...:<porta> ilha n no host hn, porta + n
+//Datagrama perdido ou buffer cheio equivale a migrante descartado. Cada
+//migrante é um datagrama (16 + 4*qtdeGenes bytes): acima do limite do UDP
+//(65507) ou do buffer de envio do socket Unix a ilha não inicia
+class TTransporteSocket : public TTransporte
+{
+   private:
+      int VP_socket;
+      bool VP_avisoTamanho;  //erro de tamanho já informado
+      vector <sockaddr_storage> VP_destinos;
+      vector <socklen_t> VP_tamDestinos;
+      vector <char> VP_buffer;
+      string VP_caminho;  //socket Unix a remover no fim
+
+      //Confere se o migrante cabe em um datagrama do socket aberto
+      bool cabeDatagrama (bool socketUnix);
+
+   public:
+      TTransporteSocket (string endereco, int ilha, int qtdeIlhas, int qtdeGenes);
+      ~TTransporteSocket ();
+
+      bool envia (int origem, int destino, const int *ids, double custo);
+      bool recebe (int destino, int *ids, double &custo);
+      bool ativo () { return VP_socket >= 0; }
+};
+
+#endif
@@ -11,168 +11,932 @@
 */
 
 #include "tsp.hpp"
+#include "leitortsplib.hpp"
+#include <string.h>
+#include <algorithm>
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const char assinaturaBinario[8] = "TSPGBIN";
+static const int versaoBinario = 1;
+static_assert(sizeof(TCabecalhoBinario) == 64, "cabeçalho binário deve ter 64 bytes");
 
 //Metodos Privados
-int TMapaGenes::getNumGeneDoArquivo(xmlDocPtr doc, xmlNode * a_node)
+
+//Avança o leitor até o texto do elemento atual. O texto aponta
+//para o buffer interno do libxml, válido até a próxima leitura
+const xmlChar *TMapaGenes::leTextoXML(xmlTextReaderPtr leitor)
 {
-    xmlNode *cur_node = NULL;
-    xmlChar *key;
-    int val;
+    if (xmlTextReaderIsEmptyElement(leitor)) return NULL;
 
-    for (cur_node = a_node; cur_node; cur_node = cur_node->next)
+    while (xmlTextReaderRead(leitor) == 1)
     {
-       if (cur_node->type == XML_ELEMENT_NODE)
+       switch (xmlTextReaderNodeType(leitor))
        {
-          if (!xmlStrcmp(cur_node->name, (xmlChar *)"description"))
-          {
-             key = xmlNodeListGetString(doc, cur_node->xmlChildrenNode, 1);
-             val = atoi((char *)key);
-             xmlFree(key);
-             return val;
-          }
+          case XML_READER_TYPE_TEXT:
+          case XML_READER_TYPE_CDATA:
+             return xmlTextReaderConstValue(leitor);
+          case XML_READER_TYPE_END_ELEMENT:
+             return NULL;
+          default:
+             break;
        }
     }
-    return 0;
- }
+    return NULL;
+}
 
-void TMapaGenes::preencheMapaDist (int geneOri, xmlDocPtr doc, xmlNode * a_node)
+//Lê um <edge cost="...">destino</edge> sem cópias intermediárias
+void TMapaGenes::leArestaXML(xmlTextReaderPtr leitor, int &geneDest, double &distancia)
 {
-    xmlNode *cur_node = NULL;
-    xmlChar *uri;
-    xmlChar *key;
-    char dist[25];
-    int geneDest;
-    float df;
+    const xmlChar *texto;
 
-    for (cur_node = a_node; cur_node; cur_node = cur_node->next)
+    distancia = 0.0;
+    if (xmlTextReaderMoveToAttribute(leitor, (const xmlChar *)"cost") == 1)
     {
-       if (cur_node->type == XML_ELEMENT_NODE)
-       {
-          uri = xmlGetProp(cur_node, (const xmlChar *)"cost");
-          sprintf(dist, "0%s", uri);
-          df = atof (dist);
-
-          key = xmlNodeListGetString(doc, cur_node->xmlChildrenNode, 1);
-          geneDest = atoi((char *)key);
+       distancia = strtod((const char *) xmlTextReaderConstValue(leitor), NULL);
+       xmlTextReaderMoveToElement(leitor);
+    }
 
-          set_distancia(geneOri, geneDest, df);
+    texto = leTextoXML(leitor);
+    geneDest = (texto)? strtol((const char *) texto, NULL, 10) : -1;
+}
 
-          xmlFree(key);
-    xmlFree(uri);
-       }
+/*
+   Leitura em fluxo (xmlTextReader) do XML da instância.
+   Os valores são gravados direto na matriz, sem montar o DOM.
+   O número de genes vem da descrição. Se não estiver lá (ex.: kro124p),
+   é obtido pelo maior destino do primeiro vértice, que é guardado até
+   o seu fim para então alocar a matriz
+*/
+void TMapaGenes::carregaXML(char *nomeArquivo)
+{
+    xmlTextReaderPtr leitor;
+    const xmlChar *nome;
+    const xmlChar *texto;
+    int qtdeDescricao = 0;
+    int geneOri = -1;
+    int geneDest;
+    double distancia;
+    vector< pair<int, double> > primeiro;
 
+    leitor = xmlReaderForFile(nomeArquivo, NULL, 0);
+    if (leitor == NULL)
+    {
+       printf("Erro ao carregar o arquivo %s\n", nomeArquivo);
+       return;
     }
- }
 
-void TMapaGenes::preencheMapa(xmlDocPtr doc, xmlNode * a_node)
-{
-    xmlNode *cur_node = NULL;
-    int gene=0;
+    VP_qtdeGenes = 0;
 
-    for (cur_node = a_node; cur_node; cur_node = cur_node->next)
+    while (xmlTextReaderRead(leitor) == 1)
     {
-       if (cur_node->type == XML_ELEMENT_NODE)
+       if (xmlTextReaderNodeType(leitor) == XML_READER_TYPE_END_ELEMENT)
        {
-          if (!xmlStrcmp(cur_node->name, (xmlChar *)"vertex"))
+          //Fim do primeiro vértice, já é possível alocar a tabela
+          if ((geneOri==0)&&(VP_qtdeGenes==0)&&(!xmlStrcmp(xmlTextReaderConstLocalName(leitor), (xmlChar *)"vertex")))
           {
-             preencheMapaDist(gene++, doc, cur_node->children);
+             if (qtdeDescricao>0) inicializa(qtdeDescricao);
+             else
+             {
+                geneDest = 0;
+                for (unsigned i=0; i<primeiro.size(); i++)
+                   if (primeiro[i].first>geneDest) geneDest = primeiro[i].first;
+                inicializa(geneDest+1);
+             }
+
+             for (unsigned i=0; i<primeiro.size(); i++)
+                set_distancia(0, primeiro[i].first, primeiro[i].second);
+             primeiro.clear();
           }
+          continue;
+       }
+
+       if (xmlTextReaderNodeType(leitor) != XML_READER_TYPE_ELEMENT) continue;
+
+       nome = xmlTextReaderConstLocalName(leitor);
+
+       if (!xmlStrcmp(nome, (xmlChar *)"edge"))
+       {
+          leArestaXML(leitor, geneDest, distancia);
+          if (geneOri == 0) primeiro.push_back(make_pair(geneDest, distancia));
+          else              set_distancia(geneOri, geneDest, distancia);
+       }
+       else if (!xmlStrcmp(nome, (xmlChar *)"vertex"))
+          geneOri++;
+       else if ((geneOri<0)&&(!xmlStrcmp(nome, (xmlChar *)"description")))
+       {
+          texto = leTextoXML(leitor);
+          if (texto) qtdeDescricao = atoi((const char *) texto);
        }
-       preencheMapa(doc, cur_node->children);
     }
+
+    xmlFreeTextReader(leitor);
+
+    if (VP_qtdeGenes <= 0)
+    {
+       printf("Erro ao carregar o arquivo %s\n", nomeArquivo);
+       return;
+    }
+
+    //Com a tabela completa, verifica se pode ser armazenada apenas a metade
+    defineArmazenamento();
 }
 
 TMapaGenes::TMapaGenes ()
 {
       VP_qtdeGenes = -1;
+      VP_passo = 0;
+      VP_mapaDist = NULL;
+      VP_capacidade = 0;
+      VP_x = NULL;
+      VP_y = NULL;
+      VP_tipoDistancia = distEUC_2D;
+      defineDistancia();
+      VP_armazenamento = armazenaAutomatico;
+      VP_modo = armazenaCompleto;
+      VP_simetrico = false;
+      VP_mapeado = NULL;
+      VP_tamMapeado = 0;
+      VP_cacheBinario = true;
+      VP_vizinhos = NULL;
+      VP_qtdeVizinhos = 0;
+      VP_qtdeVizinhosSolic = qtdeVizinhosPadrao;
 }
 
 TMapaGenes::TMapaGenes (int numGenes)
 {
+   VP_mapaDist = NULL;
+   VP_capacidade = 0;
+   VP_modo = armazenaCompleto;
+   VP_mapeado = NULL;
+   VP_tamMapeado = 0;
+   VP_cacheBinario = false;
+   VP_vizinhos = NULL;
+   VP_qtdeVizinhos = 0;
+   VP_qtdeVizinhosSolic = qtdeVizinhosPadrao;
+   VP_x = NULL;
+   VP_y = NULL;
+   VP_tipoDistancia = distEUC_2D;
+   defineDistancia();
+   VP_armazenamento = armazenaAutomatico;
    inicializa (numGenes);
 }
 
 int TMapaGenes::get_qtdeGenes () { return VP_qtdeGenes; };
+bool TMapaGenes::is_simetrico () { return VP_simetrico; }
+int TMapaGenes::get_modo ()      { return VP_modo; }
+int TMapaGenes::get_tipoDistancia () { return VP_tipoDistancia; }
+
+//O get_dist não passa pelo switch do tipo a cada chamada
+void TMapaGenes::defineDistancia ()
+{
+   switch (VP_tipoDistancia)
+   {
+      case distCEIL_2D: { VP_distCoordenada = &TMapaGenes::distTeto;             break; }
+      case distGEO:     { VP_distCoordenada = &TMapaGenes::distGeografica;       break; }
+      case distATT:     { VP_distCoordenada = &TMapaGenes::distPseudoEuclidiana; break; }
+      default:          { VP_distCoordenada = &TMapaGenes::distEuclidiana;       break; }
+   }
+}
+
+void TMapaGenes::set_armazenamento (int val) { VP_armazenamento = val; }
+int TMapaGenes::get_armazenamento ()         { return VP_armazenamento; }
+void TMapaGenes::set_cacheBinario (bool val) { VP_cacheBinario = val; }
+void TMapaGenes::set_qtdeVizinhos (int val)  { VP_qtdeVizinhosSolic = (val>0)?val:0; }
+int TMapaGenes::get_qtdeVizinhos ()          { return VP_qtdeVizinhos; }
+
+void TMapaGenes::defineArmazenamento()
+{
+   int i;
+   int j;
+   double *triangulo;
+   double *linha;
+
+   VP_simetrico = true;
+   for (i=0; (i<VP_qtdeGenes)&&(VP_simetrico); i++)
+      for (j=i+1; j<VP_qtdeGenes; j++)
+         if (VP_mapaDist[(long)i*VP_passo + j] != VP_mapaDist[(long)j*VP_passo + i])
+         {
+            VP_simetrico = false;
+            break;
+         }
+
+   if (VP_armazenamento == armazenaCompleto) return;
+
+   if (!VP_simetrico)
+   {
+      if (VP_armazenamento == armazenaTriangular)
+         printf("Instância assimétrica. Será mantida a matriz completa\n");
+      return;
+   }
+
+   //Guardando apenas o triângulo superior, com a diagonal
+   triangulo = (double *) malloc(((long)VP_qtdeGenes*(VP_qtdeGenes+1)/2)*sizeof(double));
+   if (triangulo == NULL) return;
+
+   for (i=0, linha=triangulo; i<VP_qtdeGenes; i++)
+      for (j=i; j<VP_qtdeGenes; j++)
+         *linha++ = VP_mapaDist[(long)i*VP_passo + j];
+
+   free (VP_mapaDist);
+   VP_mapaDist = triangulo;
+   VP_modo = armazenaTriangular;
+}
+
+//O binário só é usado se for mais novo que a instância e
+//tiver sido gerado com a mesma forma de armazenamento
+bool TMapaGenes::cacheValido(char *nomeArquivo, char *nomeCache)
+{
+       struct stat infoArq;
+       struct stat infoCache;
+       TCabecalhoBinario cab;
+       FILE *arq;
+       bool valido;
+
+       if ((stat(nomeArquivo, &infoArq) != 0)||(stat(nomeCache, &infoCache) != 0)) return false;
+       if (infoCache.st_mtime < infoArq.st_mtime) return false;
+
+       arq = fopen(nomeCache, "rb");
+       if (arq == NULL) return false;
+       valido = (fread(&cab, sizeof(cab), 1, arq) == 1)
+                && (memcmp(cab.assinatura, assinaturaBinario, sizeof(cab.assinatura)) == 0)
+                && (cab.versao == versaoBinario)
+                && (cab.armazenamento == VP_armazenamento);
+       fclose(arq);
+
+       return valido;
+}
 
 void TMapaGenes::carregaDoArquivo(char *nomeArquivo)
 {
-       xmlDoc *doc = NULL;
-       xmlNode *root_element = NULL;
+       int tam = strlen(nomeArquivo);
+       char *nomeCache;
+
+       //Arquivo binário gerado anteriormente
+       if ((tam > 4)&&(strcmp(nomeArquivo + tam - 4, ".bin") == 0))
+       {
+          if (carregaBinario(nomeArquivo)) geraVizinhos();
+          return;
+       }
 
-       // Lendo o arquivo
-       doc = xmlReadFile(nomeArquivo, NULL, 0);
+       nomeCache = (char *) malloc(tam + 5);
+       sprintf(nomeCache, "%s.bin", nomeArquivo);
 
-       if (doc == NULL)
+       if ((VP_cacheBinario)&&(cacheValido(nomeArquivo, nomeCache))&&(carregaBinario(nomeCache)))
        {
-          printf("Erro ao carregar o arquivo %s\n", nomeArquivo);
+          free (nomeCache);
+          geraVizinhos();
           return;
        }
 
-       // Obtendo o elemento root
-       root_element = xmlDocGetRootElement(doc);
+       //Instâncias no formato texto do TSPLIB
+       if (TLeitorTSPLIB::isTSPLIB(nomeArquivo))
+       {
+          TLeitorTSPLIB leitor;
+          //Mapa lido pela metade não segue para o binário nem para o AG
+          if (!leitor.carrega(nomeArquivo, this))
+          {
+             liberaMemoria();
+             VP_qtdeGenes = 0;
+          }
+       }
+       else
+       {
+          carregaXML(nomeArquivo);
+
+          // liberando as variaveis lobais
+          xmlCleanupParser();
+       }
 
-       //Obtendo o número de genes no arquivo
-       VP_qtdeGenes = getNumGeneDoArquivo(doc, root_element->children);
+       //Próximas execuções não precisam interpretar o texto
+       if ((VP_cacheBinario)&&(VP_qtdeGenes > 0)) salvaBinario(nomeCache);
 
-       //Alocando a tabela
-       inicializa (VP_qtdeGenes);
+       free (nomeCache);
+       geraVizinhos();
+}
 
-       //preenchendo a tabela com os valores da distáncia
-       preencheMapa(doc, root_element->children);
+void TMapaGenes::geraVizinhos()
+{
+       free (VP_vizinhos);
+       VP_vizinhos = NULL;
+       VP_qtdeVizinhos = 0;
 
-       //liberando documento
-       xmlFreeDoc(doc);
-       // liberando as variaveis lobais
-       xmlCleanupParser();
+       //Candidatos possíveis: todos os genes, menos o próprio e o gene 0
+       if ((VP_qtdeGenes < 3)||(VP_qtdeVizinhosSolic <= 0)) return;
+       VP_qtdeVizinhos = min(VP_qtdeVizinhosSolic, VP_qtdeGenes - 2);
 
+       VP_vizinhos = (int *) malloc((long)VP_qtdeGenes*VP_qtdeVizinhos*sizeof(int));
+       if (VP_vizinhos == NULL)
+       {
+          VP_qtdeVizinhos = 0;
+          return;
+       }
+
+       //Coordenadas planas não precisam comparar todos os pares (O(N²))
+       if ((VP_modo == armazenaCoordenadas)&&(VP_tipoDistancia != distGEO))
+       {
+          geraVizinhosGrade();
+          return;
+       }
+
+       //Cada gene é independente. Só é ordenado o início de cada linha.
+       //Mapas pequenos (ex.: os reduzidos da recursão) não compensam as threads
+       #pragma omp parallel if (VP_qtdeGenes > 512)
+       {
+          vector< pair<double, int> > linha(VP_qtdeGenes);
+          int qtde;
+          int *lista;
+
+          #pragma omp for schedule(dynamic, 16)
+          for (int i=0; i<VP_qtdeGenes; i++)
+          {
+             qtde = 0;
+             for (int j=1; j<VP_qtdeGenes; j++)
+                if (j != i) linha[qtde++] = make_pair(get_dist(i, j), j);
+
+             partial_sort(linha.begin(), linha.begin() + VP_qtdeVizinhos, linha.begin() + qtde);
+
+             lista = VP_vizinhos + (long)i*VP_qtdeVizinhos;
+             for (int k=0; k<VP_qtdeVizinhos; k++)
+                lista[k] = linha[k].second;
+          }
+       }
+}
+
+/*
+   Grade uniforme com cerca de dois genes por célula. Cada gene procura em
+   anéis de células ao redor da sua até que nenhum gene fora dos anéis possa
+   entrar na lista: todo gene fora do anel r está a mais de r lados de
+   distância, e o peso é crescente com a distância euclidiana. A lista é a
+   mesma da busca completa, inclusive no desempate pelo índice
+*/
+void TMapaGenes::geraVizinhosGrade()
+{
+       double (*peso)(double);
+       double xMin = VP_x[0], xMax = VP_x[0];
+       double yMin = VP_y[0], yMax = VP_y[0];
+       double lado;
+       int colunas;
+       int linhas;
+
+       switch (VP_tipoDistancia)
+       {
+          case distCEIL_2D: { peso = pesoTeto;       break; }
+          case distATT:     { peso = pesoATT;        break; }
+          default:          { peso = pesoEuclidiano; break; }
+       }
+
+       for (int i=1; i<VP_qtdeGenes; i++)
+       {
+          xMin = min(xMin, VP_x[i]);
+          xMax = max(xMax, VP_x[i]);
+          yMin = min(yMin, VP_y[i]);
+          yMax = max(yMax, VP_y[i]);
+       }
+
+       lado = sqrt((xMax-xMin)*(yMax-yMin) / (VP_qtdeGenes/2.0));
+       if (!(lado > 0)) lado = max(xMax-xMin, yMax-yMin) / VP_qtdeGenes;
+       if (!(lado > 0)) lado = 1.0;
+       //Instâncias quase em linha teriam colunas demais
+       do
+       {
+          colunas = (int) ((xMax-xMin)/lado) + 1;
+          linhas  = (int) ((yMax-yMin)/lado) + 1;
+          if ((double)colunas*linhas > 4.0*VP_qtdeGenes) lado *= 2;
+       } while ((double)colunas*linhas > 4.0*VP_qtdeGenes);
+
+       //Células em um único vetor (genes em ordem crescente em cada uma).
+       //O gene 0 fica fora, pois nunca é candidato
+       vector<int> celula(VP_qtdeGenes);
+       vector<int> inicio((long)colunas*linhas + 1, 0);
+       vector<int> genes(VP_qtdeGenes);
+
+       for (int i=0; i<VP_qtdeGenes; i++)
+       {
+          celula[i] = (int) ((VP_y[i]-yMin)/lado) * colunas + (int) ((VP_x[i]-xMin)/lado);
+          if (i > 0) inicio[celula[i]+1]++;
+       }
+       for (long c=0; c<(long)colunas*linhas; c++)
+          inicio[c+1] += inicio[c];
+       {
+          vector<int> pos(inicio.begin(), inicio.end()-1);
+          for (int i=1; i<VP_qtdeGenes; i++)
+             genes[pos[celula[i]]++] = i;
+       }
+
+       #pragma omp parallel if (VP_qtdeGenes > 512)
+       {
+          vector< pair<double, int> > candidatos;
+          double dx;
+          double dy;
+          double limite;
+          int cx;
+          int cy;
+          int passo;
+          int *lista;
+
+          #pragma omp for schedule(dynamic, 64)
+          for (int i=0; i<VP_qtdeGenes; i++)
+          {
+             candidatos.clear();
+             cx = celula[i] % colunas;
+             cy = celula[i] / colunas;
+
+             for (int r=0; ; r++)
+             {
+                //Anel r: linhas das pontas inteiras, nas demais só as duas colunas das bordas
+                for (int l=cy-r; l<=cy+r; l++)
+                {
+                   if ((l<0)||(l>=linhas)) continue;
+                   passo = ((l==cy-r)||(l==cy+r)) ? 1 : 2*r;
+                   for (int c=cx-r; c<=cx+r; c+=passo)
+                   {
+                      if ((c<0)||(c>=colunas)) continue;
+                      for (int k=inicio[l*colunas+c]; k<inicio[l*colunas+c+1]; k++)
+                      {
+                         if (genes[k] == i) continue;
+                         dx = VP_x[i] - VP_x[genes[k]];
+                         dy = VP_y[i] - VP_y[genes[k]];
+                         candidatos.push_back(make_pair(peso(dx*dx + dy*dy), genes[k]));
+                      }
+                   }
+                }
+
+                if ((r >= colunas)&&(r >= linhas)) break;
+                if ((int)candidatos.size() < VP_qtdeVizinhos) continue;
+
+                nth_element(candidatos.begin(), candidatos.begin() + VP_qtdeVizinhos-1, candidatos.end());
+                limite = r*lado*(1.0 - 1e-9);
+                if (peso(limite*limite) > candidatos[VP_qtdeVizinhos-1].first) break;
+             }
+
+             partial_sort(candidatos.begin(), candidatos.begin() + VP_qtdeVizinhos, candidatos.end());
+
+             lista = VP_vizinhos + (long)i*VP_qtdeVizinhos;
+             for (int k=0; k<VP_qtdeVizinhos; k++)
+                lista[k] = candidatos[k].second;
+          }
+       }
+}
+
+bool TMapaGenes::salvaBinario(char *nomeArquivo)
+{
+       TCabecalhoBinario cab;
+       FILE *arq;
+       char *nomeTemp;
+       bool ok;
+
+       if ((VP_qtdeGenes <= 0)||((VP_mapaDist == NULL)&&(VP_x == NULL))) return false;
+
+       memset(&cab, 0, sizeof(cab));
+       memcpy(cab.assinatura, assinaturaBinario, sizeof(cab.assinatura));
+       cab.versao = versaoBinario;
+       cab.qtdeGenes = VP_qtdeGenes;
+       cab.modo = VP_modo;
+       cab.armazenamento = VP_armazenamento;
+       cab.passo = VP_passo;
+       cab.simetrico = VP_simetrico;
+       cab.tipoDistancia = VP_tipoDistancia;
+       if (VP_modo == armazenaCoordenadas)
+          cab.tamDados = 2L*VP_qtdeGenes*sizeof(double);
+       else if (VP_modo == armazenaTriangular)
+          cab.tamDados = ((long)VP_qtdeGenes*(VP_qtdeGenes+1)/2)*sizeof(double);
+       else
+          cab.tamDados = (long)VP_passo*VP_qtdeGenes*sizeof(double);
+
+       //Grava em um temporário e renomeia, para que outro processo
+       //nunca mapeie um arquivo incompleto
+       nomeTemp = (char *) malloc(strlen(nomeArquivo) + 24);
+       sprintf(nomeTemp, "%s.%d.tmp", nomeArquivo, (int) getpid());
+
+       arq = fopen(nomeTemp, "wb");
+       if (arq == NULL)
+       {
+          free (nomeTemp);
+          return false;
+       }
+
+       ok = (fwrite(&cab, sizeof(cab), 1, arq) == 1);
+       if (VP_modo == armazenaCoordenadas)
+       {
+          ok = ok && (fwrite(VP_x, sizeof(double), VP_qtdeGenes, arq) == (size_t) VP_qtdeGenes);
+          ok = ok && (fwrite(VP_y, sizeof(double), VP_qtdeGenes, arq) == (size_t) VP_qtdeGenes);
+       }
+       else
+          ok = ok && (fwrite(VP_mapaDist, 1, cab.tamDados, arq) == (size_t) cab.tamDados);
+       ok = (fclose(arq) == 0) && ok;
+
+       if (ok) ok = (rename(nomeTemp, nomeArquivo) == 0);
+       if (!ok)
+       {
+          printf("Erro ao gravar o arquivo %s\n", nomeArquivo);
+          remove(nomeTemp);
+       }
+
+       free (nomeTemp);
+       return ok;
+}
+
+//Os dados precisam ter exatamente o tamanho que qtdeGenes, modo e passo
+//indicam, senão o arquivo está truncado ou foi alterado
+static bool tamanhoBinarioValido(const TCabecalhoBinario *cab, long tamArquivo)
+{
+       long qtde;
+
+       if (cab->qtdeGenes <= 0) return false;
+
+       switch (cab->modo)
+       {
+          case TMapaGenes::armazenaCoordenadas:
+          {
+             if ((cab->tipoDistancia < TMapaGenes::distEUC_2D)||(cab->tipoDistancia > TMapaGenes::distATT)) return false;
+             qtde = 2L*cab->qtdeGenes;
+             break;
+          }
+          case TMapaGenes::armazenaTriangular:
+          {
+             qtde = (long)cab->qtdeGenes*(cab->qtdeGenes+1)/2;
+             break;
+          }
+          case TMapaGenes::armazenaCompleto:
+          {
+             //As linhas são alinhadas em 8 doubles (alocaMatriz)
+             if (cab->passo != ((cab->qtdeGenes + 7) & ~7)) return false;
+             qtde = (long)cab->passo*cab->qtdeGenes;
+             break;
+          }
+          default:
+             return false;
+       }
+
+       return (cab->tamDados == qtde*(long)sizeof(double))&&(tamArquivo == cab->tamDados);
+}
+
+bool TMapaGenes::carregaBinario(char *nomeArquivo)
+{
+       TCabecalhoBinario *cab;
+       struct stat info;
+       void *mapa;
+       int arq;
+
+       arq = open(nomeArquivo, O_RDONLY);
+       if (arq < 0)
+       {
+          printf("Erro ao carregar o arquivo %s\n", nomeArquivo);
+          return false;
+       }
+
+       if ((fstat(arq, &info) != 0)||(info.st_size < (off_t) sizeof(TCabecalhoBinario)))
+       {
+          close(arq);
+          printf("Erro ao carregar o arquivo %s\n", nomeArquivo);
+          return false;
+       }
+
+       mapa = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, arq, 0);
+       close(arq);
+       if (mapa == MAP_FAILED)
+       {
+          printf("Erro ao carregar o arquivo %s\n", nomeArquivo);
+          return false;
+       }
+
+       cab = (TCabecalhoBinario *) mapa;
+       if ((memcmp(cab->assinatura, assinaturaBinario, sizeof(cab->assinatura)) != 0)||(cab->versao != versaoBinario)
+           ||(!tamanhoBinarioValido(cab, info.st_size - sizeof(TCabecalhoBinario))))
+       {
+          munmap(mapa, info.st_size);
+          printf("Erro: arquivo binário inválido %s\n", nomeArquivo);
+          return false;
+       }
+
+       liberaMemoria();
+
+       VP_mapeado = mapa;
+       VP_tamMapeado = info.st_size;
+       VP_qtdeGenes = cab->qtdeGenes;
+       VP_modo = cab->modo;
+       VP_passo = cab->passo;
+       VP_simetrico = cab->simetrico;
+       VP_tipoDistancia = cab->tipoDistancia;
+       defineDistancia();
+
+       //O cabeçalho tem 64 bytes, então as linhas continuam alinhadas
+       if (VP_modo == armazenaCoordenadas)
+       {
+          VP_x = (double *) ((char *) mapa + sizeof(TCabecalhoBinario));
+          VP_y = VP_x + VP_qtdeGenes;
+       }
+       else
+          VP_mapaDist = (double *) ((char *) mapa + sizeof(TCabecalhoBinario));
+
+       return true;
+}
+
+bool TMapaGenes::alocaMatriz (int numGenes)
+{
+       //Cada linha é arredondada para 8 doubles (64 bytes), assim todas
+       //começam alinhadas em uma linha de cache
+       VP_passo = (numGenes + 7) & ~7;
+
+       free (VP_mapaDist);
+       VP_capacidade = (long)VP_passo*numGenes;
+       if (posix_memalign((void **) &VP_mapaDist, 64, VP_capacidade*sizeof(double)))
+       {
+          printf("Erro ao alocar a matriz de distâncias (%ld bytes)\n", VP_capacidade*(long)sizeof(double));
+          VP_mapaDist = NULL;
+          VP_capacidade = 0;
+          return false;
+       }
+       return true;
+}
+
+void TMapaGenes::liberaMemoria ()
+{
+       free (VP_vizinhos);
+       VP_vizinhos = NULL;
+       VP_qtdeVizinhos = 0;
+
+       //Os dados mapeados do arquivo binário não são do heap
+       if (VP_mapeado != NULL)
+       {
+          munmap(VP_mapeado, VP_tamMapeado);
+          VP_mapeado = NULL;
+          VP_tamMapeado = 0;
+       }
+       else
+       {
+          free (VP_mapaDist);
+          free (VP_x);
+          free (VP_y);
+       }
+       VP_mapaDist = NULL;
+       VP_capacidade = 0;
+       VP_x = NULL;
+       VP_y = NULL;
 }
 
 void TMapaGenes::inicializa (int numGenes)
 {
        int i;
-       int j;
+       long j;
+       double *linha;
+
+       //A matriz completa atual é reaproveitada se tiver espaço
+       //(ex.: os mapas reduzidos da recursão, remontados a cada execução)
+       if ((VP_mapeado == NULL)&&(VP_modo == armazenaCompleto)&&(VP_mapaDist != NULL)
+           &&((long)((numGenes + 7) & ~7)*numGenes <= VP_capacidade))
+       {
+          free (VP_vizinhos);
+          VP_vizinhos = NULL;
+          VP_qtdeVizinhos = 0;
+          VP_passo = (numGenes + 7) & ~7;
+       }
+       else
+       {
+          liberaMemoria();
+          //Sem a matriz, o mapa fica vazio e a carga falha
+          if (!alocaMatriz (numGenes))
+          {
+             VP_qtdeGenes = 0;
+             VP_modo = armazenaCompleto;
+             return;
+          }
+       }
+
        VP_qtdeGenes = numGenes;
-       VP_mapaDist = (double **) malloc(numGenes*sizeof(double *));
+       VP_modo = armazenaCompleto;
+       VP_simetrico = false;
 
        for (i=0; i<VP_qtdeGenes; i++)
        {
-          VP_mapaDist [i] = (double *) malloc(numGenes*sizeof(double));
-          for (j=0; j<VP_qtdeGenes; j++)
+          linha = VP_mapaDist + (long)i*VP_passo;
+          for (j=0; j<VP_passo; j++)
           {
-             VP_mapaDist[i][j] = infinito; //Inicia Todos os genes com valor infinito na distância
-                                           //ou seja, não tem caminho entre eles
+             linha[j] = infinito; //Inicia Todos os genes com valor infinito na distância
+                                  //ou seja, não tem caminho entre eles
           }
-          VP_mapaDist[i][i] = 0.0; //a distância de um gene para ele mesmo é 0
+          linha[i] = 0.0; //a distância de um gene para ele mesmo é 0
        }
 
 }
 
-TMapaGenes::~TMapaGenes ()
+void TMapaGenes::inicializaCoordenadas (int numGenes, int tipoDistancia)
+{
+       liberaMemoria();
+
+       VP_qtdeGenes = numGenes;
+       VP_tipoDistancia = tipoDistancia;
+       defineDistancia();
+       VP_modo = armazenaCoordenadas;
+       //Todas as distâncias por coordenadas são simétricas
+       VP_simetrico = true;
+
+       VP_x = (double *) calloc(numGenes, sizeof(double));
+       VP_y = (double *) calloc(numGenes, sizeof(double));
+       if ((VP_x == NULL)||(VP_y == NULL))
+       {
+          printf("Erro ao alocar as coordenadas (%d genes)\n", numGenes);
+          liberaMemoria();
+          VP_qtdeGenes = 0;
+       }
+}
+
+void TMapaGenes::set_coordenada (int gene, double x, double y)
+{
+       double grau;
+
+       if ((gene<0)||(gene>=VP_qtdeGenes)||(VP_modo!=armazenaCoordenadas)) return;
+
+       if (VP_tipoDistancia == distGEO)
+       {
+          //Convertendo graus.minutos para radianos, como no TSPLIB
+          //(a parte inteira é truncada, igual ao concorde)
+          grau = (int) x;
+          x = 3.141592 * (grau + 5.0 * (x - grau) / 3.0) / 180.0;
+          grau = (int) y;
+          y = 3.141592 * (grau + 5.0 * (y - grau) / 3.0) / 180.0;
+       }
+
+       VP_x[gene] = x;
+       VP_y[gene] = y;
+}
+
+void TMapaGenes::calcLinha (int geneOri, double *linha)
+{
+       int j;
+       double dx;
+       double dy;
+       double d;
+       double xo = VP_x[geneOri];
+       double yo = VP_y[geneOri];
+
+       switch (VP_tipoDistancia)
+       {
+          case distCEIL_2D:
+             for (j=0; j<VP_qtdeGenes; j++)
+             {
+                dx = xo - VP_x[j];
+                dy = yo - VP_y[j];
+                linha[j] = ceil(sqrt(dx*dx + dy*dy));
+             }
+             break;
+          case distGEO:
+             for (j=0; j<VP_qtdeGenes; j++)
+                linha[j] = distGeografica(geneOri, j);
+             break;
+          case distATT:
+             for (j=0; j<VP_qtdeGenes; j++)
+             {
+                dx = xo - VP_x[j];
+                dy = yo - VP_y[j];
+                d = sqrt((dx*dx + dy*dy) / 10.0);
+                linha[j] = (int) (d + 0.5);
+                if (linha[j] < d) linha[j] += 1.0;
+             }
+             break;
+          default:
+             for (j=0; j<VP_qtdeGenes; j++)
+             {
+                dx = xo - VP_x[j];
+                dy = yo - VP_y[j];
+                linha[j] = (int) (sqrt(dx*dx + dy*dy) + 0.5);
+             }
+             break;
+       }
+
+       linha[geneOri] = 0.0;
+}
+
+void TMapaGenes::materializaCoordenadas (int modo)
 {
        int i;
+       double *matriz;
+       double *linha;
+
+       //As coordenadas continuam em uso durante o cálculo das linhas
+       free (VP_mapaDist);
+       VP_mapaDist = NULL;
 
-       for (i=VP_qtdeGenes-1; i>=0; i--)
+       if (modo == armazenaTriangular)
        {
-          free (VP_mapaDist [i]);
+          matriz = (double *) malloc(((long)VP_qtdeGenes*(VP_qtdeGenes+1)/2)*sizeof(double));
+          linha = (double *) malloc(VP_qtdeGenes*sizeof(double));
+          if ((matriz == NULL)||(linha == NULL))
+          {
+             free (matriz);
+             free (linha);
+             return;
+          }
+
+          for (i=0; i<VP_qtdeGenes; i++)
+          {
+             calcLinha(i, linha);
+             memcpy(matriz + ((long)i*(2*VP_qtdeGenes-i-1))/2 + i, linha + i, (VP_qtdeGenes-i)*sizeof(double));
+          }
+          free (linha);
        }
+       else
+       {
+          if (!alocaMatriz(VP_qtdeGenes)) return;
+
+          for (i=0; i<VP_qtdeGenes; i++)
+             calcLinha(i, VP_mapaDist + (long)i*VP_passo);
+
+          matriz = VP_mapaDist;
+       }
+
+       free (VP_x);
+       free (VP_y);
+       VP_x = NULL;
+       VP_y = NULL;
+       VP_mapaDist = matriz;
+       VP_modo = modo;
+}
 
-       if (VP_qtdeGenes>0) free (VP_mapaDist);
+void TMapaGenes::finalizaCoordenadas ()
+{
+       if (VP_modo != armazenaCoordenadas) return;
+
+       switch (VP_armazenamento)
+       {
+          case armazenaCompleto:
+          case armazenaTriangular:
+          {
+             materializaCoordenadas(VP_armazenamento);
+             break;
+          }
+          case armazenaAutomatico:
+          {
+             //Instâncias pequenas ficam mais rápidas com a matriz
+             if (VP_qtdeGenes <= limiteMatrizCoordenadas)
+                materializaCoordenadas(armazenaTriangular);
+             break;
+          }
+          default:
+             break;
+       }
+}
 
+TMapaGenes::~TMapaGenes ()
+{
+       liberaMemoria();
  }
 
 void TMapaGenes::set_distancia(int geneOri, int geneDest, double distancia)
 {
        //a distância do gene para ele mesmo não pode ser alterada
        //nenum gene pode está fora do indice d tabela
+       //no modo por coordenadas as distâncias são sempre calculadas
+       //e o mapeamento do arquivo binário é apenas para leitura
+       if ((VP_modo == armazenaCoordenadas)||(VP_mapeado != NULL)) return;
+
        if ((geneOri!=geneDest)&&(geneOri>=0)&&(geneOri<VP_qtdeGenes)&&(geneDest>=0)&&(geneDest<VP_qtdeGenes))
-          VP_mapaDist[geneOri][geneDest] = distancia;
+       {
+          if (VP_modo == armazenaTriangular)
+          {
+             if (geneOri > geneDest)
+             {
+                int g = geneOri;
+                geneOri = geneDest;
+                geneDest = g;
+             }
+             VP_mapaDist[((long)geneOri*(2*VP_qtdeGenes-geneOri-1))/2 + geneDest] = distancia;
+          }
+          else
+             VP_mapaDist[(long)geneOri*VP_passo + geneDest] = distancia;
+       }
 }
 
 double TMapaGenes::get_distancia(int geneOri, int geneDest)
 {
        //nenum gene pode está fora do indice d tabela
        if ((geneOri<VP_qtdeGenes)&&(geneDest>=0)&&(geneDest<VP_qtdeGenes))
-          return VP_mapaDist[geneOri][geneDest];
+          return get_dist(geneOri, geneDest);
        else
           return 0.0;
 }
+
+uint64_t TMapaGenes::assinatura()
+{
+       //FNV-1a sobre a quantidade de genes e uma amostra de distâncias:
+       //as arestas (i, i+1) nos dois sentidos e (i, 7i+3). O(n)
+       uint64_t h = 14695981039346656037ULL;
+       int n = VP_qtdeGenes;
+       double amostra[3];
+
+       h = (h ^ (uint64_t)n) * 1099511628211ULL;
+       for (int i=0; i<n; i++)
+       {
+          amostra[0] = get_dist(i, (i+1)%n);
+          amostra[1] = get_dist((i+1)%n, i);
+          amostra[2] = get_dist(i, (int)((7L*i + 3)%n));
+          const unsigned char *b = (const unsigned char *) amostra;
+          for (unsigned k=0; k<sizeof(amostra); k++)
+             h = (h ^ b[k]) * 1099511628211ULL;
+       }
+       return h;
+}
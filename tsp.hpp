@@ -14,24 +14,153 @@
 #define	_TSP_H
 
 
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
 #include "tipos.cpp"
+#include <vector>
 #include <libxml/parser.h>
-#include <libxml/tree.h>
+#include <libxml/xmlreader.h>
+
+using namespace std;
+
+/*******************************************************
+Cabeçalho do arquivo binário da instância (64 bytes).
+Logo após vêm os dados, na mesma forma que ficam em memória:
+matriz completa (passo x N), triângulo superior ou as
+coordenadas (x[N] e depois y[N])
+********************************************************/
+struct TCabecalhoBinario
+{
+   char assinatura[8];
+   int versao;
+   int qtdeGenes;
+   int modo;
+   int armazenamento;   //forma solicitada quando o arquivo foi gerado
+   int passo;
+   int simetrico;
+   int tipoDistancia;
+   int reservado1;
+   long tamDados;       //em bytes
+   char reservado2[16];
+};
 
 /*******************************************************
 classe de TMapaGenes. Todas as distâncias entre os genes
 ********************************************************/
 class TMapaGenes
 {
+   public:
+      //Formas de armazenamento da matriz de distâncias
+      static const int armazenaCompleto   = 0; //matriz N x N
+      static const int armazenaTriangular = 1; //apenas o triângulo superior
+      static const int armazenaAutomatico = 2; //triangular se a instância for simétrica
+      static const int armazenaCoordenadas = 3; //apenas as coordenadas, distância calculada na hora
+
+      //Tipos de distância por coordenadas (como no TSPLIB)
+      static const int distEUC_2D  = 0;
+      static const int distCEIL_2D = 1;
+      static const int distGEO     = 2;
+      static const int distATT     = 3;
+
+      //No modo automático, instâncias por coordenadas com mais genes que
+      //este limite não têm a matriz montada, a distância é calculada na hora
+      static const int limiteMatrizCoordenadas = 3000;
+
+      //Tamanho padrão da lista de vizinhos mais próximos de cada gene
+      static const int qtdeVizinhosPadrao = 10;
+
    private:
-      double **VP_mapaDist;
+      //Matriz de distâncias em um único bloco contíguo, linha a linha.
+      //Cada linha ocupa VP_passo posições (múltiplo de uma linha de cache)
+      //No modo triangular, a linha i guarda apenas as colunas i..N-1
+      double *VP_mapaDist;
+      int VP_passo;
+      long VP_capacidade;     //doubles alocados para a matriz completa
       int VP_qtdeGenes;
 
-   //Metodos Privados
-   int getNumGeneDoArquivo(xmlDocPtr doc, xmlNode * a_node);
-   void preencheMapaDist (int geneOri, xmlDocPtr doc, xmlNode * a_node);
+      int VP_armazenamento;   //forma solicitada (completo, triangular, automático ou coordenadas)
+      int VP_modo;            //forma em uso (completo, triangular ou coordenadas)
+      bool VP_simetrico;
 
-   void preencheMapa(xmlDocPtr doc, xmlNode * a_node);
+      //Modo por coordenadas. Para GEO, já guardam latitude e longitude em radianos
+      double *VP_x;
+      double *VP_y;
+      int VP_tipoDistancia;
+
+      //Quando carregado do arquivo binário, os dados apontam para o mapeamento
+      void *VP_mapeado;
+      long VP_tamMapeado;
+      bool VP_cacheBinario;
+
+      //Lista de candidatos: para cada gene, os VP_qtdeVizinhos genes mais
+      //próximos (pela linha da matriz), em ordem crescente de distância.
+      //O gene 0 fica fora das listas, pois é sempre o primeiro da rota
+      int *VP_vizinhos;
+      int VP_qtdeVizinhos;        //tamanho de cada lista
+      int VP_qtdeVizinhosSolic;   //tamanho solicitado
+
+   //Metodos Privados
+   const xmlChar *leTextoXML(xmlTextReaderPtr leitor);
+   void leArestaXML(xmlTextReaderPtr leitor, int &geneDest, double &distancia);
+   void carregaXML(char *nomeArquivo);
+   bool cacheValido(char *nomeArquivo, char *nomeCache);
+
+   //Monta a matriz (completa ou triangular) a partir das coordenadas
+   void materializaCoordenadas(int modo);
+   bool alocaMatriz(int numGenes);
+   void liberaMemoria();
+
+   //Peso TSPLIB em função do quadrado da distância euclidiana
+   static double pesoEuclidiano(double d2) { return (int) (sqrt(d2) + 0.5); }
+   static double pesoTeto(double d2)       { return ceil(sqrt(d2)); }
+   static double pesoATT(double d2)
+   {
+      double d = sqrt(d2 / 10.0);
+      int t = (int) (d + 0.5);
+      return (t < d) ? t + 1 : t;
+   }
+
+   inline double distEuclidiana(int geneOri, int geneDest)
+   {
+      double dx = VP_x[geneOri] - VP_x[geneDest];
+      double dy = VP_y[geneOri] - VP_y[geneDest];
+      return pesoEuclidiano(dx*dx + dy*dy);
+   }
+
+   inline double distTeto(int geneOri, int geneDest)
+   {
+      double dx = VP_x[geneOri] - VP_x[geneDest];
+      double dy = VP_y[geneOri] - VP_y[geneDest];
+      return pesoTeto(dx*dx + dy*dy);
+   }
+
+   inline double distPseudoEuclidiana(int geneOri, int geneDest)
+   {
+      double dx = VP_x[geneOri] - VP_x[geneDest];
+      double dy = VP_y[geneOri] - VP_y[geneDest];
+      return pesoATT(dx*dx + dy*dy);
+   }
+
+   inline double distGeografica(int geneOri, int geneDest)
+   {
+      double q1 = cos(VP_y[geneOri] - VP_y[geneDest]);
+      double q2 = cos(VP_x[geneOri] - VP_x[geneDest]);
+      double q3 = cos(VP_x[geneOri] + VP_x[geneDest]);
+      return (int) (6378.388 * acos(0.5*((1.0+q1)*q2 - (1.0-q1)*q3)) + 1.0);
+   }
+
+   //Função de distância do tipo em uso, escolhida uma vez na carga
+   double (TMapaGenes::*VP_distCoordenada)(int geneOri, int geneDest);
+   void defineDistancia();
+
+   inline double distCoordenada(int geneOri, int geneDest)
+   {
+      return (this->*VP_distCoordenada)(geneOri, geneDest);
+   }
+
+   //Listas de vizinhos por uma grade uniforme (coordenadas planas)
+   void geraVizinhosGrade();
 
    public:
       TMapaGenes ();
@@ -39,17 +168,86 @@ class TMapaGenes
       TMapaGenes (int numGenes);
 
       int get_qtdeGenes ();
-
+      bool is_simetrico ();
+      int get_modo ();
+
+      //Deve ser definido antes da carga da instância
+      void set_armazenamento (int val);
+      int get_armazenamento ();
+      //Se gera / usa o arquivo binário (<instância>.bin) na carga
+      void set_cacheBinario (bool val);
+      //Tamanho das listas de vizinhos mais próximos (0 desliga)
+      void set_qtdeVizinhos (int val);
+      int get_qtdeVizinhos ();
+
+      //Carrega a instância em XML, no formato do TSPLIB (.tsp) ou binário (.bin).
+      //Para XML e TSPLIB, usa o binário <instância>.bin, se estiver atualizado,
+      //ou o gera após a leitura
       void carregaDoArquivo(char *nomeArquivo);
 
+      //Arquivo binário, mapeado em memória (mmap) apenas para leitura.
+      //Processos que usam a mesma instância compartilham as páginas
+      bool carregaBinario(char *nomeArquivo);
+      bool salvaBinario(char *nomeArquivo);
+
       void inicializa (int numGenes);
+      //Inicia o mapa no modo por coordenadas
+      void inicializaCoordenadas (int numGenes, int tipoDistancia);
+      void set_coordenada (int gene, double x, double y);
+      int get_tipoDistancia ();
+      //Com todas as coordenadas informadas, define a forma de armazenamento
+      void finalizaCoordenadas ();
+
+      //Calcula as distâncias de geneOri para todos os genes.
+      //Laço simples, que pode ser vetorizado pelo compilador
+      void calcLinha (int geneOri, double *linha);
 
       ~TMapaGenes ();
 
       void set_distancia(int geneOri, int geneDest, double distancia);
 
+      //Verifica a simetria da matriz carregada e, se for o caso,
+      //compacta para o triângulo superior. Chamado ao fim da carga
+      void defineArmazenamento();
+
+      //Monta as listas de vizinhos, em paralelo. Chamado ao fim da carga
+      void geraVizinhos();
+
+      //Os vizinhos de um gene, do mais próximo para o mais distante.
+      //A lista tem get_qtdeVizinhos() posições
+      inline const int *get_vizinhos(int gene)
+      {
+         return VP_vizinhos + (long)gene*VP_qtdeVizinhos;
+      }
+
       double get_distancia(int geneOri, int geneDest);
 
+      //Identifica a instância carregada (ilhas em processos conferem se
+      //todos usam a mesma)
+      uint64_t assinatura();
+
+      //Acesso rápido, sem verificação de limites. Utilizado nos laços
+      //críticos (indivíduo, mutação e cruzamento), onde os genes são
+      //sempre válidos. O get_distancia fica para a carga e usos externos
+      inline double get_dist(int geneOri, int geneDest)
+      {
+         if (VP_modo == armazenaCompleto)
+            return VP_mapaDist[(long)geneOri*VP_passo + geneDest];
+
+         if (VP_modo == armazenaTriangular)
+         {
+            if (geneOri > geneDest)
+            {
+               int g = geneOri;
+               geneOri = geneDest;
+               geneDest = g;
+            }
+            return VP_mapaDist[((long)geneOri*(2*VP_qtdeGenes-geneOri-1))/2 + geneDest];
+         }
+
+         return (geneOri == geneDest) ? 0.0 : distCoordenada(geneOri, geneDest);
+      }
+
 };
 
 #endif
@@ -0,0 +1,116 @@
+/*
+*  tspconv.cpp
+*
+*  Conversor do rastro binário das gerações (.trc) para o texto do log:
+*     ;Profundidade;..;Melhor;..;Pior;..;Media;..;Tempo;..
+*  Uso: tspconv <arquivo.trc> [arquivo de saída] [-e]
+*  Sem arquivo de saída, escreve na saída padrão. O Tempo é contado do
+*  início do AG, em segundos inteiros, como no log texto. Com -e as linhas
+*  da profundidade 0 começam com "Geração X / Y:", como no log texto com
+*  printParcial, e todas terminam com os contadores da recursão
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 17/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "registro.hpp"
+
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+   TCabecalhoRegistros cabecalho;
+   TRegistroGeracao registro;
+   const char *arqEntrada = NULL;
+   const char *arqSaida = NULL;
+   bool estendido = false;
+   FILE *entrada;
+   FILE *saida = stdout;
+   long qtde = 0;
+
+   for (int i=1; i<argc; i++)
+   {
+      if (!strcmp(argv[i], "-e")) estendido = true;
+      else if (arqEntrada == NULL) arqEntrada = argv[i];
+      else if (arqSaida == NULL) arqSaida = argv[i];
+      else
+      {
+         printf("Erro: parâmetro inválido %s\n", argv[i]);
+         return 1;
+      }
+   }
+
+   if (arqEntrada == NULL)
+   {
+      printf("Uso: %s <arquivo.trc> [arquivo de saída] [-e]\n", argv[0]);
+      return 1;
+   }
+
+   entrada = fopen(arqEntrada, "rb");
+   if (entrada == NULL)
+   {
+      printf("Erro ao abrir o arquivo %s\n", arqEntrada);
+      return 1;
+   }
+
+   if ((fread(&cabecalho, sizeof(cabecalho), 1, entrada) != 1)||
+       (memcmp(cabecalho.assinatura, assinaturaRegistros, sizeof(cabecalho.assinatura)) != 0))
+   {
+      printf("Erro: %s não é um arquivo de registros\n", arqEntrada);
+      fclose(entrada);
+      return 1;
+   }
+
+   if (cabecalho.tamRegistro != sizeof(TRegistroGeracao))
+   {
+      printf("Erro: registros de %u bytes, esperado %u\n", cabecalho.tamRegistro, (unsigned)sizeof(TRegistroGeracao));
+      fclose(entrada);
+      return 1;
+   }
+
+   if (arqSaida != NULL)
+   {
+      saida = fopen(arqSaida, "w");
+      if (saida == NULL)
+      {
+         printf("Erro ao criar o arquivo %s\n", arqSaida);
+         fclose(entrada);
+         return 1;
+      }
+   }
+
+   while (fread(&registro, sizeof(registro), 1, entrada) == 1)
+   {
+      //O log texto usa difftime(time(), sysTime1): o relógio de parede do
+      //registro, truncado em segundos, menos o início do AG
+      int64_t real = cabecalho.inicioReal + (registro.tempo - cabecalho.inicio);
+      double tempo = (double)(real / 1000000000 - cabecalho.inicioExecucao);
+
+      if (estendido && (registro.profundidade == 0))
+         fprintf(saida, "Geração %d / %u:", registro.geracao, cabecalho.maxGeracao);
+
+      fprintf(saida, ";Profundidade;%d;Melhor;%f;Pior;%f;Media;%f;Tempo;%f",
+              registro.profundidade, registro.melhor, registro.pior, registro.media, tempo);
+
+      if (estendido)
+         fprintf(saida, ";Entradas Recursivas;%u;Execuções Recursivas;%u;Execuções das Combinações;%u",
+                 registro.entradas, registro.execucoes, registro.combinacoes);
+
+      fprintf(saida, "\n");
+      qtde++;
+   }
+
+   fclose(entrada);
+   if (saida != stdout)
+   {
+      fclose(saida);
+      printf("%ld registros convertidos\n", qtde);
+   }
+   return 0;
+}
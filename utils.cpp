@@ -1,5 +1,6 @@
 #include "utils.hpp"
 #include <iostream>
+#include <omp.h>
 
 double TUtils::fatorialStirling (int n)
 {
@@ -19,29 +20,73 @@ double TUtils::fatorialStirling (int n)
    return result;
 }
 
-void TUtils::initRnd ()
+thread_local TGerador *TUtils::VP_gerador = NULL;
+uint64_t TUtils::VP_semente = 0;
+
+//Cada thread tem o seu, criado no primeiro sorteio dela, com o fluxo do
+//número da thread na equipe OpenMP (a ordem do primeiro sorteio depende do
+//escalonamento). A thread principal fica com o fluxo 0 (initRnd)
+TGerador &TUtils::padrao()
+{
+   static thread_local TGerador gerador(VP_semente, omp_get_thread_num());
+   return gerador;
+}
+
+void TUtils::initRnd (uint64_t semente)
+{
+   VP_semente = semente;
+   padrao().semeia(semente, 0);
+}
+
+uint64_t TUtils::sementeAleatoria ()
+{
+   std::random_device rd;
+   uint64_t semente = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+
+   semente ^= ((uint64_t)rd() << 32) | rd();
+   return semente;
+}
+
+uint64_t TUtils::get_semente () { return VP_semente; }
+
+void TUtils::set_gerador(TGerador *gerador) { VP_gerador = gerador; }
+TGerador *TUtils::get_gerador() { return VP_gerador; }
+
+uint64_t TUtils::sorteia()
 {
-   srand(time(NULL));
+   return (VP_gerador == NULL)?padrao().proximo():VP_gerador->proximo();
 }
 
 int TUtils::rnd(unsigned low, unsigned high)
 {
-   return rand() % (high-low+1) + low;
+   TGerador &gerador = (VP_gerador == NULL)?padrao():*VP_gerador;
+
+   //Intervalo vazio ou de um valor: limitado(0) daria 32 bits inteiros
+   if (high <= low) return low;
+   return gerador.limitado(high-low+1) + low;
 }
 
-double TUtils::rndd(double low, double high)
+void TUtils::rnd(int *destino, int qtde, unsigned low, unsigned high)
 {
-	return rndd(low, high, 1000);
+   TGerador &gerador = (VP_gerador == NULL)?padrao():*VP_gerador;
+
+   if (high <= low)
+   {
+      for (int i=0; i<qtde; i++)
+         destino[i] = low;
+      return;
+   }
+
+   gerador.preenche((uint32_t *)destino, qtde, high-low+1);
+   for (int i=0; i<qtde; i++)
+      destino[i] += low;
 }
 
-double TUtils::rndd(double low, double high, unsigned calibracao)
+double TUtils::rndd(double low, double high)
 {
-	//Gerando um número randomico entre 0 e VP_MaxrndD
-   unsigned r = rand() % calibracao;
-	
-	//Após achar um randomico entre 0 e VP_MaxrndD
-	//vou converter para a escala entre low e high
-	return ((((double)r)/calibracao)*(high-low))+low;
+   TGerador &gerador = (VP_gerador == NULL)?padrao():*VP_gerador;
+
+   return gerador.real()*(high-low) + low;
 }
 
 /**
@@ -53,9 +98,6 @@ double TUtils::rndd(double low, double high, unsigned calibracao)
 bool TUtils::flip(float prob)
 {
    if (prob==0) return 0;
-	
-	double d = rnd(1, 10000);
-	double p = prob * 10000;
-  
-  return (d <= p)?1:0;
+
+   return rndd(0, 1) < prob;
 }
\ No newline at end of file
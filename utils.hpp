@@ -1,12 +1,21 @@
 
 #include <random>
 #include <chrono>
+#include "gerador.hpp"
 
 #ifndef _UTIL_H
 #define	_UTIL_H
 
 class TUtils
 {
+   private:
+      //Gerador definido para a thread corrente. Sem gerador (NULL) é usado
+      //o gerador padrão da thread
+      static thread_local TGerador *VP_gerador;
+      static uint64_t VP_semente;
+
+      static TGerador &padrao();
+
    public:
 
       /************************************************************************************
@@ -16,11 +25,19 @@ class TUtils
       ************************************************************************************/
       static double fatorialStirling (int n);
 
-      static void initRnd ();
-		static void set_calibraRndD(unsigned max);
+      static void initRnd (uint64_t semente);
+      //Semente diferente a cada chamada, mesmo no mesmo segundo
+      static uint64_t sementeAleatoria ();
+      static uint64_t get_semente ();
+      //Define o gerador usado pela thread corrente (NULL volta ao padrão)
+      static void set_gerador(TGerador *gerador);
+      static TGerador *get_gerador();
+      static uint64_t sorteia();
+      //Inteiro entre low e high; low se high <= low
       static int rnd(unsigned low, unsigned high);
+      //Sorteios em lote, qtde inteiros entre low e high
+      static void rnd(int *destino, int qtde, unsigned low, unsigned high);
 		static double rndd(double low, double high);
-		static double rndd(double low, double high, unsigned calibracao);
         static bool flip(float prob);
     
     template <class T1, class T2, class Pred = std::less<T2> >
@@ -0,0 +1,294 @@
+/*
+*  verifica.cpp
+*
+*  Verificação das contas incrementais do indivíduo (make check). Em rotas
+*  aleatórias, compara os deltas de get_dif_reverso, get_dist_sub_reverso,
+*  inverte_sub_indice, troca_sub e troca_indice com o custo da rota
+*  recalculado do zero, e o melhorPossivel com a força bruta para n pequeno.
+*  Usa as instâncias passadas na linha de comando e mapas aleatórios,
+*  simétricos e assimétricos, gerados aqui
+*  Uso: verifica [instâncias...]
+*  Autor: Geraldo José Ferreira Chagas Junior - gjr.doc@gmail.com
+*
+*  PPGI - NCE - UFRJ
+*  Data Criação: 17/10/2026
+*  Datas de Modificações:
+*
+*/
+
+#include "individuo.hpp"
+#include <stdio.h>
+#include <math.h>
+
+using namespace std;
+
+static long testes = 0;
+static long erros = 0;
+
+//Custo de uma rota (ids dos genes) direto do mapa
+static double custoRota (TIndividuo *ind, const vector<int> &rota)
+{
+   TMapaGenes *mapa = ind->getMapa();
+   int n = rota.size();
+   double custo = 0.0;
+
+   for (int p=0; p<n; p++)
+      custo += mapa->get_dist(ind->get_por_id(rota[p])->ori, ind->get_por_id(rota[(p+1)%n])->dest);
+   return custo;
+}
+
+static vector<int> rotaAtual (TIndividuo *ind)
+{
+   const int *rota = ind->get_rota();
+   return vector<int>(rota, rota + ind->get_qtdeGenes());
+}
+
+static void confere (bool ok, const char *nome, const char *operacao, double obtido, double esperado)
+{
+   testes++;
+   if (ok) return;
+
+   erros++;
+   if (erros <= 20) printf("Erro: %s %s obtido %f esperado %f\n", nome, operacao, obtido, esperado);
+}
+
+static bool igual (double a, double b)
+{
+   return fabs(a - b) <= 1e-6*(1.0 + fabs(b));
+}
+
+//Encadeamento (prox / ant / i) coerente com a rota
+static bool encadeado (TIndividuo *ind)
+{
+   int n = ind->get_qtdeGenes();
+
+   for (int p=0; p<n; p++)
+   {
+      TGene *g = ind->get_por_indice(p);
+      if ((g->i != p)||(g->prox != ind->get_por_indice(ind->ind_prox(p)))||(g->ant != ind->get_por_indice(ind->ind_ant(p))))
+         return false;
+   }
+   return true;
+}
+
+/*
+   Sequência aleatória de consultas e movimentos. Os movimentos são aplicados
+   sem recalcular a distância, como no AG, para que as correções dos custos
+   acumulados (assimétrico) também sejam verificadas
+*/
+static void verificaMovimentos (TIndividuo *ind, const char *nome, int qtde)
+{
+   int n = ind->get_qtdeGenes();
+   int i, j, tam1, tam2;
+   vector<int> rota;
+   vector<int> esperada;
+   double esperado;
+
+   for (int it=0; it<qtde; it++)
+   {
+      rota = rotaAtual(ind);
+      i = TUtils::rnd(1, n-1);
+      j = TUtils::rnd(1, n-1);
+
+      switch (TUtils::rnd(0, 5))
+      {
+         case 0:
+         {
+            //Distância com o trecho invertido, sem alterar o indivíduo
+            if (i > j) swap(i, j);
+            esperada = rota;
+            reverse(esperada.begin() + i, esperada.begin() + j + 1);
+            esperado = custoRota(ind, esperada);
+            double obtido = ind->get_dist_sub_reverso_indice(i, j);
+            confere(igual(obtido, esperado), nome, "get_dist_sub_reverso", obtido, esperado);
+            break;
+         }
+         case 1:
+         {
+            //Diferença das arestas internas, inclusive trechos que dão a volta
+            TMapaGenes *mapa = ind->getMapa();
+            esperado = 0.0;
+            for (int p=i; p!=j; p=ind->ind_prox(p))
+            {
+               TGene *g = ind->get_por_indice(p);
+               TGene *h = ind->get_por_indice(ind->ind_prox(p));
+               esperado += mapa->get_dist(h->ori, g->dest) - mapa->get_dist(g->ori, h->dest);
+            }
+            double obtido = ind->get_dif_reverso(ind->get_por_indice(i), ind->get_por_indice(j));
+            confere(igual(obtido, esperado), nome, "get_dif_reverso", obtido, esperado);
+            break;
+         }
+         case 2:
+         {
+            if (i > j) swap(i, j);
+            esperada = rota;
+            reverse(esperada.begin() + i, esperada.begin() + j + 1);
+            ind->inverte_sub_indice(i, j);
+            esperado = custoRota(ind, esperada);
+            confere((rotaAtual(ind) == esperada)&&(encadeado(ind)), nome, "inverte_sub_indice (rota)", 0, 0);
+            confere(igual(ind->get_distancia(), esperado), nome, "inverte_sub_indice", ind->get_distancia(), esperado);
+            break;
+         }
+         case 3:
+         {
+            esperada = rota;
+            swap(esperada[i], esperada[j]);
+            ind->troca_indice(i, j);
+            esperado = custoRota(ind, esperada);
+            confere((rotaAtual(ind) == esperada)&&(encadeado(ind)), nome, "troca_indice (rota)", 0, 0);
+            confere(igual(ind->get_distancia(), esperado), nome, "troca_indice", ind->get_distancia(), esperado);
+            break;
+         }
+         default:
+         {
+            //Blocos [i, i+tam1) e [j, j+tam2), negativos são invertidos.
+            //Fica bloco 2, meio, bloco 1
+            if (i > j) swap(i, j);
+            tam1 = TUtils::rnd(0, min(4, j-i));
+            tam2 = TUtils::rnd(0, min(4, n-j));
+            if ((tam1 == 0)&&(tam2 == 0)) break;
+
+            vector<int> b1(rota.begin() + i, rota.begin() + i + tam1);
+            vector<int> meio(rota.begin() + i + tam1, rota.begin() + j);
+            vector<int> b2(rota.begin() + j, rota.begin() + j + tam2);
+            if (TUtils::flip(0.5)) { reverse(b1.begin(), b1.end()); tam1 = -tam1; }
+            if (TUtils::flip(0.5)) { reverse(b2.begin(), b2.end()); tam2 = -tam2; }
+
+            esperada.assign(rota.begin(), rota.begin() + i);
+            esperada.insert(esperada.end(), b2.begin(), b2.end());
+            esperada.insert(esperada.end(), meio.begin(), meio.end());
+            esperada.insert(esperada.end(), b1.begin(), b1.end());
+            esperada.insert(esperada.end(), rota.begin() + j + abs(tam2), rota.end());
+
+            ind->troca_sub(i, tam1, j, tam2);
+            esperado = custoRota(ind, esperada);
+            confere((rotaAtual(ind) == esperada)&&(encadeado(ind)), nome, "troca_sub (rota)", 0, 0);
+            confere(igual(ind->get_distancia(), esperado), nome, "troca_sub", ind->get_distancia(), esperado);
+            break;
+         }
+      }
+   }
+}
+
+//Menor rota por força bruta, com o gene da posição 0 fixo
+static double forcaBruta (TIndividuo *ind)
+{
+   vector<int> rota = rotaAtual(ind);
+   double melhor = infinito;
+
+   sort(rota.begin() + 1, rota.end());
+   do
+   {
+      melhor = min(melhor, custoRota(ind, rota));
+   } while (next_permutation(rota.begin() + 1, rota.end()));
+
+   return melhor;
+}
+
+static void verificaMelhorPossivel (TMapaGenes *mapa, const char *nome, bool reduzido)
+{
+   TIndividuo ind(mapa, NULL);
+   int qtdeMapa = mapa->get_qtdeGenes();
+
+   for (int n=3; (n<=9)&&(n<=qtdeMapa); n++)
+   {
+      for (int k=0; k<4; k++)
+      {
+         //Indivíduos reduzidos (como os da recursão): cada gene entra por
+         //uma cidade e sai por outra
+         vector<TTipoConversao> genes(n);
+         for (int g=0; g<n; g++)
+         {
+            genes[g].ulOrig = TUtils::rnd(0, qtdeMapa-1);
+            genes[g].prDest = reduzido ? TUtils::rnd(0, qtdeMapa-1) : genes[g].ulOrig;
+         }
+
+         ind.novo(genes, 0);
+         ind.embaralha();
+         ind.recalcDist();
+
+         double esperado = min(forcaBruta(&ind), ind.get_distancia());
+         ind.melhorPossivel();
+         confere(igual(ind.get_distancia(), esperado)&&igual(custoRota(&ind, rotaAtual(&ind)), esperado)&&(encadeado(&ind)),
+                 nome, reduzido ? "melhorPossivel (reduzido)" : "melhorPossivel", ind.get_distancia(), esperado);
+      }
+   }
+}
+
+static void verificaMapa (TMapaGenes *mapa, const char *nome)
+{
+   long errosAntes = erros;
+   long testesAntes = testes;
+   TIndividuo ind(mapa, NULL);
+
+   ind.novo();
+   ind.embaralha();
+   ind.recalcDist();
+   verificaMovimentos(&ind, nome, 20000);
+
+   //Genes reduzidos desligam o caminho simétrico mesmo no mapa simétrico
+   vector<TTipoConversao> genes(min(mapa->get_qtdeGenes(), 60));
+   for (unsigned g=0; g<genes.size(); g++)
+   {
+      genes[g].ulOrig = TUtils::rnd(0, mapa->get_qtdeGenes()-1);
+      genes[g].prDest = TUtils::rnd(0, mapa->get_qtdeGenes()-1);
+   }
+   ind.novo(genes, 0);
+   ind.embaralha();
+   ind.recalcDist();
+   verificaMovimentos(&ind, nome, 20000);
+
+   verificaMelhorPossivel(mapa, nome, false);
+   verificaMelhorPossivel(mapa, nome, true);
+
+   printf("%-24s %s %6ld testes  %s\n", nome, mapa->is_simetrico() ? "simétrico  " : "assimétrico",
+          testes - testesAntes, (erros == errosAntes) ? "ok" : "ERRO");
+}
+
+//Mapa aleatório com custos inteiros
+static void mapaAleatorio (TMapaGenes *mapa, int n, bool simetrico)
+{
+   mapa->inicializa(n);
+   for (int i=0; i<n; i++)
+      for (int j=simetrico?i+1:0; j<n; j++)
+      {
+         if (i == j) continue;
+         double d = TUtils::rnd(1, 1000);
+         mapa->set_distancia(i, j, d);
+         if (simetrico) mapa->set_distancia(j, i, d);
+      }
+   mapa->defineArmazenamento();
+}
+
+int main(int argc, char *argv[])
+{
+   char nome[32];
+
+   TUtils::initRnd(20171005);
+
+   for (int a=1; a<argc; a++)
+   {
+      TMapaGenes mapa;
+      mapa.set_cacheBinario(false);
+      mapa.carregaDoArquivo(argv[a]);
+      if (mapa.get_qtdeGenes() <= 0)
+      {
+         printf("Erro ao carregar %s\n", argv[a]);
+         return 1;
+      }
+      verificaMapa(&mapa, argv[a]);
+   }
+
+   int tamanhos[] = {12, 57, 200};
+   for (int t=0; t<3; t++)
+      for (int s=0; s<2; s++)
+      {
+         TMapaGenes mapa(tamanhos[t]);
+         mapaAleatorio(&mapa, tamanhos[t], s == 0);
+         sprintf(nome, "aleatório %d", tamanhos[t]);
+         verificaMapa(&mapa, nome);
+      }
+
+   printf("%ld testes, %ld erros\n", testes, erros);
+   return (erros == 0) ? 0 : 1;
+}